@@ -0,0 +1,6 @@
+(defun weigh (a b c d) (+ (* a 3) (* b 5) (- c d)))
+
+(defvar acc 0)
+(dotimes (i 100000)
+  (setq acc (weigh i (+ i 1) (* 2 i) acc)))
+(println acc)
@@ -0,0 +1,8 @@
+(let ((sum 0) (difference 0) (product 1) (quotient 0) (remainder 0))
+  (dotimes (i 20000)
+    (setq sum (+ sum i))
+    (setq difference (- difference i))
+    (setq product (* (mod product 1000) 3))
+    (setq quotient (/ i 7))
+    (setq remainder (mod i 13)))
+  (println sum " " difference " " product " " quotient " " remainder))
@@ -0,0 +1,7 @@
+(let ((sum 0.0) (difference 0.0) (product 1.0) (quotient 0.0))
+  (dotimes (i 20000)
+    (setq sum (+ sum i))
+    (setq difference (- i difference))
+    (setq product (* 1 product))
+    (setq quotient (/ i 4.0)))
+  (println sum " " difference " " product " " quotient))
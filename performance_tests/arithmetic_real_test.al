@@ -0,0 +1,8 @@
+(let ((sum 0.0) (difference 0.0) (product 1.0) (quotient 0.0) (x 0.5))
+  (dotimes (i 20000)
+    (setq x (+ x 0.25))
+    (setq sum (+ sum x))
+    (setq difference (- difference x))
+    (setq product (* product 1.0001))
+    (setq quotient (/ x 3.0)))
+  (println sum " " difference " " product " " quotient))
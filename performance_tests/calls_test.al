@@ -0,0 +1,7 @@
+(defun add-one (x) (+ x 1))
+(defun twice (x) (add-one (add-one x)))
+
+(defvar acc 0)
+(dotimes (i 100000)
+  (setq acc (twice acc)))
+(println acc)
@@ -0,0 +1,15 @@
+(defvar lst (mapcar (lambda (x) (* 2 x)) (range 0 20000)))
+
+(defun walk-sum (l)
+  (let ((s 0))
+    (while l
+      (setq s (+ s (car l)))
+      (setq l (cdr l)))
+    s))
+
+(defun rec-sum (l)
+  (if l (+ (car l) (rec-sum (cdr l))) 0))
+
+(println (walk-sum lst))
+(println (walk-sum (slice lst 100 15000)))
+(println (rec-sum (slice lst 0 50)))
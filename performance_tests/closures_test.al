@@ -0,0 +1,7 @@
+(defun sum-with-closures (n)
+  (let ((a 1) (b 2) (c 3) (d 4) (e 5) (f 6) (g 7) (h 8) (acc 0))
+    (dotimes (i n)
+      (setq acc (+ acc (funcall (lambda (x) (+ x a)) i))))
+    acc))
+
+(println (sum-with-closures 50000))
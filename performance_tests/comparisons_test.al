@@ -0,0 +1,9 @@
+(let ((count 0))
+  (dotimes (i 20000)
+    (when (< i 10000) (setq count (+ count 1)))
+    (when (<= i 10000) (setq count (+ count 1)))
+    (when (> i 10000.5) (setq count (+ count 1)))
+    (when (>= i 10000) (setq count (+ count 1)))
+    (when (== i 5000) (setq count (+ count 1)))
+    (when (!= i 5000.0) (setq count (+ count 1))))
+  (println count))
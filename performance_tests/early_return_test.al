@@ -0,0 +1,25 @@
+(defun find-first (lst target)
+  (dolist (el lst)
+    (when (== el target)
+      (return el)))
+  'nil)
+
+
+(defun find-triple (n)
+  (dotimes (a 10)
+    (dotimes (b 10)
+      (dotimes (c 10)
+        (when (== (+ a b c) n)
+          (return (list a b c))))))
+  'nil)
+
+
+(defvar lst (range 0 20))
+
+(dotimes (i 20000)
+  (find-first lst 5))
+
+(dotimes (i 5000)
+  (find-triple 3))
+
+(println (find-first lst 5) (find-triple 3))
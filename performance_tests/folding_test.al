@@ -0,0 +1,10 @@
+(defconst folding-scale (* 4 1024))
+(defconst folding-mask (- (<< 1 10) 1))
+
+(defun folding-sum (n)
+  (let ((acc 0))
+    (dotimes (i n)
+      (setq acc (+ acc (mod (* i (/ folding-scale 4)) (+ folding-mask 1)) (* 2 3 7))))
+    acc))
+
+(println (folding-sum 100000))
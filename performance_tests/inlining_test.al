@@ -0,0 +1,10 @@
+(defun square (x) (* x x))
+(defun clamp (x lo hi) (max lo (min x hi)))
+
+(defun sum-of-squares (n)
+  (let ((acc 0))
+    (dotimes (i n)
+      (setq acc (+ acc (clamp (square i) 0 1000))))
+    acc))
+
+(println (sum-of-squares 50000))
@@ -0,0 +1,8 @@
+(import 'stack :all)
+
+(defvar st (stack-create))
+(dotimes (i 50000)
+  (stack-push st i)
+  (stack-first st)
+  (stack-empty st))
+(println (stack-length st))
@@ -0,0 +1,12 @@
+(defmacro square-sum (a b)
+  `(+ (* ,a ,a) (* ,b ,b)))
+
+(defmacro increment (var)
+  `(setq ,var (+ ,var 1)))
+
+(defvar acc 0)
+(defvar i 0)
+(while (< i 100000)
+  (setq acc (square-sum i 2))
+  (increment i))
+(println acc)
@@ -0,0 +1,6 @@
+(import 'math :all)
+
+(defvar acc 0.0)
+(dotimes (i 100000)
+  (setq acc (+ acc (exp2 (log2 2.0)) (todegrees 0.0))))
+(println acc)
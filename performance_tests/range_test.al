@@ -0,0 +1,7 @@
+(defvar sum 0)
+(dolist (i (range 0 2000000))
+  (setq sum (+ sum i)))
+(println sum)
+
+(println (length (filter (lambda (x) (== (mod x 7) 0)) (range 0 200000))))
+(println (nth (range 0 10000000) 9999999))
@@ -0,0 +1,11 @@
+(defvar a-rather-long-global-variable-name-used-as-a-counter 0)
+
+(defun a-rather-long-function-name-that-bumps-the-counter (a-rather-long-parameter-name)
+  (setq a-rather-long-global-variable-name-used-as-a-counter
+        (+ a-rather-long-global-variable-name-used-as-a-counter a-rather-long-parameter-name)))
+
+(let ((another-rather-long-local-variable-name 1))
+  (dotimes (i 50000)
+    (a-rather-long-function-name-that-bumps-the-counter another-rather-long-local-variable-name)))
+
+(println a-rather-long-global-variable-name-used-as-a-counter)
@@ -0,0 +1,6 @@
+(defun sum-to (n acc)
+  (if (== n 0)
+      acc
+    (sum-to (- n 1) (+ acc n))))
+
+(println (sum-to 100000 0))
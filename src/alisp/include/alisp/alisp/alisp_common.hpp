@@ -26,6 +26,8 @@
 #include <utility>
 #include <memory>
 #include <unordered_map>
+#include <mutex>
+#include <limits>
 
 
 #include "alisp/utility/meta.hpp"
@@ -57,6 +59,7 @@ constexpr const char *alobject_type_to_string(ALObjectType type)
 class ALObject;
 #ifdef USE_MANUAL_MEMORY
 using ALObjectPtr                  = ALObject *;
+using ALObjectCPtr                 = const ALObject *;
 inline constexpr bool USING_SHARED = false;
 #else
 using ALObjectPtr                  = std::shared_ptr<ALObject>;
@@ -80,7 +83,17 @@ class alobject_error : public std::runtime_error
 namespace env
 {
 class Environment;
-}
+class Module;
+
+// Every symbol name is mapped once to a dense integer id. All symbols with
+// the same name carry the same id, so they can be compared and hashed
+// without looking at the name.
+using SymbolId = std::uint32_t;
+
+SymbolId symbol_id(const std::string &t_name);
+
+const std::string &symbol_name(SymbolId t_id);
+}  // namespace env
 namespace eval
 {
 class Evaluator;
@@ -93,6 +106,217 @@ struct Prim
     ALObjectPtr (*function)(const ALObjectPtr &obj, env::Environment *env, eval::Evaluator *eval);
 };
 
+// Argument count bounds of a primitive, compiled once from its signature
+// when the primitive is registered.
+struct ArgBounds
+{
+    static constexpr std::uint32_t UNBOUNDED = std::numeric_limits<std::uint32_t>::max();
+
+    std::uint32_t min{ 0 };
+    std::uint32_t max{ UNBOUNDED };
+    bool empty{ false };
+    bool well_formed{ true };
+};
+
+// Inline cache of a call site - a list form whose head is a symbol bound to a
+// function in a root scope. The entry is valid while its epoch is the current
+// call epoch of the environment and the module that it was resolved in is
+// the active one.
+struct CallSiteCache
+{
+    enum class Kind : std::uint8_t
+    {
+        PRIME,
+        MACRO,
+        FUNCTION
+    };
+
+    size_t epoch{ 0 };
+    const void *module{ nullptr };
+    ALObjectPtr *cell{ nullptr };
+    Kind kind{ Kind::FUNCTION };
+    bool managed{ false };
+    const ArgBounds *bounds{ nullptr };
+    ALObjectPtr expansion{ nullptr };
+};
+
+// Properties live in a side table that is allocated only when the first
+// property of an object is set. Property names are interned into small
+// integer keys; the names used by the interpreter itself are registered up
+// front so that they can be accessed without hashing a string.
+enum class PropKey : std::uint32_t
+{
+    NAME = 0,
+    MODULE,
+    DOC,
+    SIGNATURE,
+    MANAGED,
+    CLOSURE,
+    CAPTURES
+};
+
+class PropTable
+{
+  public:
+    using key_type   = std::uint32_t;
+    using entry_type = std::pair<key_type, ALObjectPtr>;
+
+  private:
+    struct Registry
+    {
+        std::mutex lock;
+        std::vector<std::string> names{ "--name--",    "--module--",  "--doc--",     "--signature--",
+                                        "--managed--", "--closure--", "--captures--" };
+        std::unordered_map<std::string, key_type> keys;
+
+        Registry()
+        {
+            for (size_t i = 0; i < std::size(names); ++i)
+            {
+                keys.insert({ names[i], static_cast<key_type>(i) });
+            }
+        }
+    };
+
+    static Registry &registry()
+    {
+        static Registry reg;
+        return reg;
+    }
+
+    std::vector<entry_type> m_entries;
+    CallSiteCache m_call_site;
+    std::unique_ptr<const ArgBounds> m_bounds;
+    env::Module *m_module{ nullptr };
+
+  public:
+    static key_type key(PropKey t_key) { return static_cast<key_type>(t_key); }
+
+    static key_type intern(const std::string &t_name)
+    {
+        auto &reg = registry();
+        std::lock_guard<std::mutex> guard{ reg.lock };
+
+        if (auto it = reg.keys.find(t_name); it != std::end(reg.keys))
+        {
+            return it->second;
+        }
+
+        const auto new_key = static_cast<key_type>(std::size(reg.names));
+        reg.names.push_back(t_name);
+        reg.keys.insert({ t_name, new_key });
+        return new_key;
+    }
+
+    static bool lookup(const std::string &t_name, key_type &t_key)
+    {
+        auto &reg = registry();
+        std::lock_guard<std::mutex> guard{ reg.lock };
+
+        if (auto it = reg.keys.find(t_name); it != std::end(reg.keys))
+        {
+            t_key = it->second;
+            return true;
+        }
+        return false;
+    }
+
+    static std::string name(key_type t_key)
+    {
+        auto &reg = registry();
+        std::lock_guard<std::mutex> guard{ reg.lock };
+        return reg.names[t_key];
+    }
+
+    const ALObjectPtr *find(key_type t_key) const
+    {
+        for (auto &[entry_key, value] : m_entries)
+        {
+            if (entry_key == t_key)
+            {
+                return &value;
+            }
+        }
+        return nullptr;
+    }
+
+    void set(key_type t_key, ALObjectPtr t_value)
+    {
+        if (t_key == key(PropKey::MODULE))
+        {
+            m_module = nullptr;
+        }
+
+        for (auto &[entry_key, value] : m_entries)
+        {
+            if (entry_key == t_key)
+            {
+                value = std::move(t_value);
+                return;
+            }
+        }
+        m_entries.emplace_back(t_key, std::move(t_value));
+    }
+
+    bool remove(key_type t_key)
+    {
+        if (t_key == key(PropKey::MODULE))
+        {
+            m_module = nullptr;
+        }
+
+        for (auto it = std::begin(m_entries); it != std::end(m_entries); ++it)
+        {
+            if (it->first == t_key)
+            {
+                m_entries.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    auto begin() const { return std::begin(m_entries); }
+    auto end() const { return std::end(m_entries); }
+
+    CallSiteCache &call_site() { return m_call_site; }
+
+    const ArgBounds *bounds() const { return m_bounds.get(); }
+
+    void set_bounds(ArgBounds t_bounds) { m_bounds = std::make_unique<const ArgBounds>(t_bounds); }
+
+    // The module named by the --module-- property; forgotten whenever the
+    // property changes.
+    env::Module *module() const { return m_module; }
+
+    void set_module(env::Module *t_module) { m_module = t_module; }
+};
+
+// The place in the source from which a list was parsed. Locations are kept
+// in a side table keyed by the address of the list, so parsed code carries
+// no per-list objects for them; the file names are stored once and referred
+// to by index.
+struct SourceLocation
+{
+    std::uint32_t file{ 0 };
+    std::uint32_t line{ 0 };
+    std::uint32_t column{ 0 };
+};
+
+class SourceMap
+{
+  public:
+    static void add(ALObject *t_form, SourceLocation t_location);
+
+    static const SourceLocation *find(const ALObject *t_form);
+
+    static void forget(const ALObject *t_form);
+
+    static std::uint32_t file_id(const std::string &t_file);
+
+    static const std::string &file_name(std::uint32_t t_id);
+};
+
 class ALObject : public std::conditional_t<USING_SHARED, std::enable_shared_from_this<ALObject>, utility::empty_base>
 {
   public:
@@ -102,7 +326,30 @@ class ALObject : public std::conditional_t<USING_SHARED, std::enable_shared_from
     using real_type   = double;
     using string_type = std::string;
 
-    using data_type = std::variant<int_type, real_type, string_type, list_type, view_type>;
+    // The integers from, from + step, ... below to; the elements are created
+    // only when the list is accessed as a whole.
+    struct range_type
+    {
+        int_type from;
+        int_type to;
+        int_type step;
+
+        size_t size() const { return static_cast<size_t>((to - from + step - 1) / step); }
+    };
+
+    // The elements begin, ..., end - 1 of a list whose elements are shared
+    // with other lists. The shared elements are never modified; they are
+    // copied out when the list is accessed as a whole.
+    struct slice_type
+    {
+        std::shared_ptr<list_type> elements;
+        size_t begin;
+        size_t end;
+
+        size_t size() const { return end - begin; }
+    };
+
+    using data_type = std::variant<int_type, real_type, string_type, list_type, view_type, range_type, slice_type>;
 
   private:
     template<typename Type, typename Visitor, typename Or> decltype(auto) visit_or(Visitor &&visitor, Or &&other) const
@@ -118,6 +365,17 @@ class ALObject : public std::conditional_t<USING_SHARED, std::enable_shared_from
     }
 
 
+    // A view does not own the elements it refers to and must not be kept
+    // alive by an error that is thrown through the scope of the viewed list.
+    ALObjectCPtr error_object() const
+    {
+        if (check_temp_flag())
+        {
+            return nullptr;
+        }
+        return shared_from_this();
+    }
+
     template<typename Type> void check() const
     {
         if (!std::get_if<Type>(&m_data))
@@ -125,13 +383,18 @@ class ALObject : public std::conditional_t<USING_SHARED, std::enable_shared_from
             if constexpr (std::is_same_v<Type, list_type>)
             {
                 if (check_temp_flag()) return;
-                throw alobject_error("Not a list object.", shared_from_this());
+                if (is_lazy())
+                {
+                    const_cast<ALObject *>(this)->materialize();
+                    return;
+                }
+                throw alobject_error("Not a list object.", error_object());
             }
             if constexpr (std::is_same_v<Type, string_type>)
-                throw alobject_error("Not a string object.", shared_from_this());
+                throw alobject_error("Not a string object.", error_object());
             if constexpr (std::is_same_v<Type, real_type>)
-                throw alobject_error("Not a real object.", shared_from_this());
-            if constexpr (std::is_same_v<Type, int_type>) throw alobject_error("Not a int object.", shared_from_this());
+                throw alobject_error("Not a real object.", error_object());
+            if constexpr (std::is_same_v<Type, int_type>) throw alobject_error("Not a int object.", error_object());
         }
     }
 
@@ -147,12 +410,18 @@ class ALObject : public std::conditional_t<USING_SHARED, std::enable_shared_from
     explicit ALObject(real_type value) : m_data(value), m_type(ALObjectType::REAL_VALUE) {}
     explicit ALObject(int_type value) : m_data(value), m_type(ALObjectType::INT_VALUE) {}
     ALObject(string_type value, bool symbol = false)
-      : m_data(value), m_type(symbol ? ALObjectType::SYMBOL : ALObjectType::STRING_VALUE)
+      : m_data(value)
+      , m_type(symbol ? ALObjectType::SYMBOL : ALObjectType::STRING_VALUE)
+      , m_symbol_id(symbol ? env::symbol_id(value) : 0)
     {
     }
 
     explicit ALObject(list_type value) : m_data(std::move(value)), m_type(ALObjectType::LIST) {}
 
+    explicit ALObject(range_type value) : m_data(value), m_type(ALObjectType::LIST) {}
+
+    explicit ALObject(slice_type value) : m_data(std::move(value)), m_type(ALObjectType::LIST) {}
+
     explicit ALObject(view_type value) : m_data(std::move(value)), m_type(ALObjectType::LIST) { set_temp_flag(); }
     ALObject(list_type::iterator value_1, list_type::iterator value_2)
       : m_data(view_type(value_1, value_2)), m_type(ALObjectType::LIST)
@@ -160,6 +429,19 @@ class ALObject : public std::conditional_t<USING_SHARED, std::enable_shared_from
         set_temp_flag();
     }
 
+    ~ALObject()
+    {
+        if (check_located_flag())
+        {
+            SourceMap::forget(this);
+        }
+    }
+
+#ifdef USE_MANUAL_MEMORY
+    ALObjectPtr shared_from_this() { return this; }
+    ALObjectCPtr shared_from_this() const { return this; }
+#endif
+
     ALObjectType type() const { return m_type; }
     bool is_int() const { return m_type == ALObjectType::INT_VALUE; }
     bool is_string() const { return m_type == ALObjectType::STRING_VALUE; }
@@ -167,6 +449,8 @@ class ALObject : public std::conditional_t<USING_SHARED, std::enable_shared_from
     bool is_list() const { return m_type == ALObjectType::LIST; }
     bool is_sym() const { return m_type == ALObjectType::SYMBOL; }
 
+    env::SymbolId symbol_id() const { return m_symbol_id; }
+
     ALObjectPtr &i(const size_t index)
     {
         if (check_temp_flag())
@@ -197,16 +481,46 @@ class ALObject : public std::conditional_t<USING_SHARED, std::enable_shared_from
         }
 
         return visit_or<list_type>([](const auto &vec) { return std::size(vec); },
-                                   []() { return list_type::size_type(0); });
+                                   [this]() {
+                                       if (const auto slice = std::get_if<slice_type>(&m_data))
+                                       {
+                                           return slice->size();
+                                       }
+                                       const auto range = std::get_if<range_type>(&m_data);
+                                       return range ? range->size() : list_type::size_type(0);
+                                   });
     }
 
     auto size() const { return length(); }
 
+    // Like i() but does not force lazy lists to create all of their elements.
+    ALObjectPtr element(const size_t index) const
+    {
+        if (const auto slice = std::get_if<slice_type>(&m_data))
+        {
+            return (*slice->elements)[slice->begin + index];
+        }
+        if (const auto range = std::get_if<range_type>(&m_data))
+        {
+            return range_element(*range, index);
+        }
+        return i(index);
+    }
+
+    bool is_lazy() const
+    {
+        return std::get_if<slice_type>(&m_data) != nullptr or std::get_if<range_type>(&m_data) != nullptr;
+    }
+
+    // The elements begin, ..., end - 1 as a new list. Lazy lists give lazy
+    // sublists that do not copy any elements.
+    ALObjectPtr sublist(size_t t_begin, size_t t_end) const;
+
     list_type &children()
     {
         check<list_type>();
         if (check_temp_flag())
-            throw alobject_error("Accesing the children elements of a temporary object.", shared_from_this());
+            throw alobject_error("Accesing the children elements of a temporary object.", error_object());
         return std::get<list_type>(m_data);
     }
 
@@ -214,7 +528,7 @@ class ALObject : public std::conditional_t<USING_SHARED, std::enable_shared_from
     {
         check<list_type>();
         if (check_temp_flag())
-            throw alobject_error("Accesing the children elements of a temporary object.", shared_from_this());
+            throw alobject_error("Accesing the children elements of a temporary object.", error_object());
         return std::get<list_type>(m_data);
     }
 
@@ -240,19 +554,27 @@ class ALObject : public std::conditional_t<USING_SHARED, std::enable_shared_from
         {
             return static_cast<real_type>(std::get<int_type>(m_data));
         }
-        throw alobject_error("Not a number object.", shared_from_this());
+        throw alobject_error("Not a number object.", error_object());
         return 0.0;
     }
 
     int_type to_int() const
     {
+        if (const auto val = std::get_if<int_type>(&m_data))
+        {
+            return *val;
+        }
         check<int_type>();
-        return std::get<int_type>(m_data);
+        return 0;
     }
 
     void set(int_type val)
     {
         check<int_type>();
+        if (check_immediate_flag())
+        {
+            throw alobject_error("Immediate values can not be modified.", error_object());
+        }
         m_data = val;
     }
 
@@ -265,6 +587,10 @@ class ALObject : public std::conditional_t<USING_SHARED, std::enable_shared_from
     void set(string_type val)
     {
         check<string_type>();
+        if (m_type == ALObjectType::SYMBOL)
+        {
+            m_symbol_id = env::symbol_id(val);
+        }
         m_data = std::move(val);
     }
 
@@ -295,6 +621,12 @@ class ALObject : public std::conditional_t<USING_SHARED, std::enable_shared_from
     //   0000 0000 0000 0001 0000 0000 0000 0000 - CONST
     //   0000 0000 0000 0010 0000 0000 0000 0000 - CHAR
     //   0000 0000 0000 0100 0000 0000 0000 0000 - TEMP_OBJECT
+    //   0000 0000 0000 1000 0000 0000 0000 0000 - RESOLVED
+    //   0000 0000 0001 0000 0000 0000 0000 0000 - EVALED
+    //   0000 0000 0010 0000 0000 0000 0000 0000 - IMMEDIATE
+    //   0000 0000 0100 0000 0000 0000 0000 0000 - GC_MARK
+    //   0000 0000 1000 0000 0000 0000 0000 0000 - PERMANENT
+    //   0000 0001 0000 0000 0000 0000 0000 0000 - LOCATED
 
     struct AlObjectFlags
     {
@@ -307,6 +639,12 @@ class ALObject : public std::conditional_t<USING_SHARED, std::enable_shared_from
         constexpr static std::uint32_t CONST     = 0x00010000;
         constexpr static std::uint32_t CHAR      = 0x00020000;
         constexpr static std::uint32_t TEMP      = 0x00040000;
+        constexpr static std::uint32_t RESOLVED  = 0x00080000;
+        constexpr static std::uint32_t EVALED    = 0x00100000;
+        constexpr static std::uint32_t IMMEDIATE = 0x00200000;
+        constexpr static std::uint32_t GC_MARK   = 0x00400000;
+        constexpr static std::uint32_t PERMANENT = 0x00800000;
+        constexpr static std::uint32_t LOCATED   = 0x01000000;
     };
 
     inline void set_function_flag() { m_flags |= AlObjectFlags::FUN; }
@@ -315,6 +653,12 @@ class ALObject : public std::conditional_t<USING_SHARED, std::enable_shared_from
     inline void set_const_flag() { m_flags |= AlObjectFlags::CONST; }
     inline void set_char_flag() { m_flags |= AlObjectFlags::CHAR; }
     inline void set_temp_flag() { m_flags |= AlObjectFlags::TEMP; }
+    inline void set_resolved_flag() { m_flags |= AlObjectFlags::RESOLVED; }
+    inline void set_evaled_flag() { m_flags |= AlObjectFlags::EVALED; }
+    inline void set_immediate_flag() { m_flags |= AlObjectFlags::IMMEDIATE; }
+    inline void set_mark_flag() { m_flags |= AlObjectFlags::GC_MARK; }
+    inline void set_permanent_flag() { m_flags |= AlObjectFlags::PERMANENT; }
+    inline void set_located_flag() { m_flags |= AlObjectFlags::LOCATED; }
 
     inline void reset_function_flag() { m_flags &= ~AlObjectFlags::FUN; }
     inline void reset_prime_flag() { m_flags &= ~AlObjectFlags::PRIME; }
@@ -322,6 +666,7 @@ class ALObject : public std::conditional_t<USING_SHARED, std::enable_shared_from
     inline void reset_const_flag() { m_flags &= ~AlObjectFlags::CONST; }
     inline void reset_char_flag() { m_flags &= ~AlObjectFlags::CHAR; }
     inline void reset_temp_flag() { m_flags &= ~AlObjectFlags::TEMP; }
+    inline void reset_mark_flag() { m_flags &= ~AlObjectFlags::GC_MARK; }
 
     inline bool check_function_flag() const { return (m_flags & AlObjectFlags::FUN) > 0; }
     inline bool check_prime_flag() const { return (m_flags & AlObjectFlags::PRIME) > 0; }
@@ -329,9 +674,20 @@ class ALObject : public std::conditional_t<USING_SHARED, std::enable_shared_from
     inline bool check_const_flag() const { return (m_flags & AlObjectFlags::CONST) > 0; }
     inline bool check_char_flag() const { return (m_flags & AlObjectFlags::CHAR) > 0; }
     inline bool check_temp_flag() const { return (m_flags & AlObjectFlags::TEMP) > 0; }
+    inline bool check_resolved_flag() const { return (m_flags & AlObjectFlags::RESOLVED) > 0; }
+    inline bool check_evaled_flag() const { return (m_flags & AlObjectFlags::EVALED) > 0; }
+    inline bool check_immediate_flag() const { return (m_flags & AlObjectFlags::IMMEDIATE) > 0; }
+    inline bool check_mark_flag() const { return (m_flags & AlObjectFlags::GC_MARK) > 0; }
+    inline bool check_permanent_flag() const { return (m_flags & AlObjectFlags::PERMANENT) > 0; }
+    inline bool check_located_flag() const { return (m_flags & AlObjectFlags::LOCATED) > 0; }
+
+    static constexpr std::uint32_t GLOBAL_LOCATION = 0xFF;
 
-    void set_location(std::uint_fast16_t loc) { m_flags &= (~AlObjectFlags::LOC) | (loc << 4); }
-    auto get_location() { return ((m_flags & AlObjectFlags::LOC) >> 4); }
+    void set_location(std::uint32_t loc)
+    {
+        m_flags = (m_flags & ~AlObjectFlags::LOC) | ((loc << 4) & AlObjectFlags::LOC);
+    }
+    auto get_location() const { return ((m_flags & AlObjectFlags::LOC) >> 4); }
 
     auto begin()
     {
@@ -391,31 +747,108 @@ class ALObject : public std::conditional_t<USING_SHARED, std::enable_shared_from
 
     ALObjectPtr get_prop(const std::string &t_name) const
     {
-        auto search = m_props.find(t_name);
-        if (search != m_props.end())
+        PropTable::key_type key;
+        return m_props and PropTable::lookup(t_name, key) ? get_prop(key) : nullptr;
+    }
+
+    ALObjectPtr get_prop(PropKey t_key) const { return get_prop(PropTable::key(t_key)); }
+
+    void set_prop(const std::string &t_name, ALObjectPtr t_value)
+    {
+        set_prop(PropTable::intern(t_name), std::move(t_value));
+    }
+
+    void set_prop(PropKey t_key, ALObjectPtr t_value) { set_prop(PropTable::key(t_key), std::move(t_value)); }
+
+    bool prop_exists(const std::string &t_name) const { return get_prop(t_name) != nullptr; }
+
+    bool prop_exists(PropKey t_key) const { return m_props and m_props->find(PropTable::key(t_key)) != nullptr; }
+
+    bool remove_prop(const std::string &t_name)
+    {
+        PropTable::key_type key;
+        return m_props and PropTable::lookup(t_name, key) and m_props->remove(key);
+    }
+
+    CallSiteCache &call_site()
+    {
+        if (!m_props)
         {
-            return search->second;
+            m_props = std::make_unique<PropTable>();
         }
-        return nullptr;
+        return m_props->call_site();
     }
 
-    void set_prop(const std::string &t_name, ALObjectPtr t_value)
+    const ArgBounds *arg_bounds() const { return m_props ? m_props->bounds() : nullptr; }
+
+    env::Module *module() const { return m_props ? m_props->module() : nullptr; }
+
+    void set_module(env::Module *t_module)
     {
-        if (m_props.count(t_name) > 0)
+        if (!m_props)
         {
-            m_props.at(t_name) = std::move(t_value);
+            m_props = std::make_unique<PropTable>();
         }
-        else
+        m_props->set_module(t_module);
+    }
+
+    void set_arg_bounds(ArgBounds t_bounds)
+    {
+        if (!m_props)
         {
-            m_props.insert({ t_name, std::move(t_value) });
+            m_props = std::make_unique<PropTable>();
         }
+        m_props->set_bounds(t_bounds);
     }
 
-    bool prop_exists(const std::string &t_name) const { return m_props.count(t_name) != 0; }
+    std::vector<std::string> prop_names() const
+    {
+        std::vector<std::string> names;
+        if (m_props)
+        {
+            for (auto &[key, _] : *m_props)
+            {
+                names.push_back(PropTable::name(key));
+            }
+        }
+        return names;
+    }
 
-    auto &props() { return m_props; }
+    // Calls the function with every object that this one references
+    // directly: the elements of a list and the values of the properties.
+    template<typename Callable> void visit_references(Callable &&t_fun)
+    {
+        if (const auto list = std::get_if<list_type>(&m_data))
+        {
+            for (auto &child : *list)
+            {
+                t_fun(child);
+            }
+        }
+        else if (const auto view = std::get_if<view_type>(&m_data))
+        {
+            for (auto &child : *view)
+            {
+                t_fun(child);
+            }
+        }
+        else if (const auto slice = std::get_if<slice_type>(&m_data))
+        {
+            for (auto index = slice->begin; index < slice->end; ++index)
+            {
+                t_fun((*slice->elements)[index]);
+            }
+        }
 
-    const auto &props() const { return m_props; }
+        if (m_props)
+        {
+            for (auto &[_, value] : *m_props)
+            {
+                t_fun(value);
+            }
+            t_fun(m_props->call_site().expansion);
+        }
+    }
 
     std::string pretty_print() const
     {
@@ -455,11 +888,35 @@ class ALObject : public std::conditional_t<USING_SHARED, std::enable_shared_from
     }
 
   private:
+    static ALObjectPtr range_element(const range_type &t_range, size_t t_index);
+
+    void materialize();
+
+    ALObjectPtr get_prop(PropTable::key_type t_key) const
+    {
+        if (!m_props)
+        {
+            return nullptr;
+        }
+        auto value = m_props->find(t_key);
+        return value ? *value : nullptr;
+    }
+
+    void set_prop(PropTable::key_type t_key, ALObjectPtr t_value)
+    {
+        if (!m_props)
+        {
+            m_props = std::make_unique<PropTable>();
+        }
+        m_props->set(t_key, std::move(t_value));
+    }
+
     data_type m_data;
     Prim::func_type m_prime = nullptr;
     const ALObjectType m_type;
-    std::uint_fast32_t m_flags = 0;
-    std::unordered_map<std::string, ALObjectPtr> m_props;
+    std::uint32_t m_flags = 0;
+    env::SymbolId m_symbol_id{ 0 };
+    std::unique_ptr<PropTable> m_props;
 };
 
 inline std::ostream &operator<<(std::ostream &os, const ALObject &t_obj)
@@ -40,6 +40,7 @@
 #include "alisp/alisp/alisp_streams.hpp"
 #include "alisp/alisp/alisp_warnings.hpp"
 #include "alisp/alisp/alisp_optimizer.hpp"
+#include "alisp/alisp/alisp_vm.hpp"
 
 #include "alisp/utility/files.hpp"
 #include "alisp/utility/env.hpp"
@@ -56,7 +57,9 @@ enum class EngineSettings
     EVAL_DEBUG,
     QUICK_INIT,
     DISABLE_DEBUG_MODE,
-    OPTIMIZATION
+    OPTIMIZATION,
+    FULL_OPTIMIZATION,
+    BYTECODE
 };
 
 
@@ -74,6 +77,7 @@ class LanguageEngine
     env::Environment m_environment;
     std::unique_ptr<parser::ALParser<env::Environment>> m_parser;
     eval::Evaluator m_evaluator;
+    vm::VirtualMachine m_vm;
     optimizer::MainOptimizer g_optimizer;
 
     std::vector<EngineSettings> m_settings;
@@ -88,6 +92,8 @@ class LanguageEngine
         return std::find(std::begin(m_settings), std::end(m_settings), t_setting) != std::end(m_settings);
     }
 
+    optimizer::Level optimization_level();
+
     void do_eval(std::string &t_input, const std::string &t_file, bool t_print_res = false);
 
     std::pair<bool, int> handle_exceptions() const noexcept;
@@ -129,9 +135,9 @@ class LanguageEngine
     {
         std::vector<std::string> vec;
 
-        for (auto [name, _] : env::Environment::g_internal_symbols)
+        for (auto &[id, _] : env::Environment::g_internal_symbols)
         {
-            vec.push_back(name);
+            vec.push_back(env::symbol_name(id));
         }
 
         return vec;
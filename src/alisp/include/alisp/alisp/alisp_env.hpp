@@ -24,6 +24,9 @@
 #include <iostream>
 #include <string_view>
 #include <string>
+#include <limits>
+#include <algorithm>
+#include <optional>
 
 #include "alisp/alisp/alisp_common.hpp"
 #include "alisp/alisp/alisp_macros.hpp"
@@ -34,6 +37,7 @@
 
 #include "alisp/utility/helpers.hpp"
 #include "alisp/utility/macros.hpp"
+#include "alisp/utility/containers.hpp"
 
 namespace alisp::eval
 {
@@ -57,23 +61,146 @@ namespace detail
 struct CellStack
 {
   public:
-    using Scope      = std::unordered_map<std::string, ALObjectPtr>;
-    using StackFrame = std::vector<Scope>;
-    using Stack      = std::vector<StackFrame>;
+    // The global cells are referenced by pointer from the caches, so the
+    // values must stay in place when the table grows.
+    using Scope = NodeMap<SymbolId, ALObjectPtr>;
+
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+    // Every local variable of the current frame lives in one flat vector of
+    // cells. Cells put through `bind` follow the layout computed by the
+    // lexical resolver, so a resolved symbol can be read with a single indexed
+    // load; cells put through `put` are "dynamic" and disable the fast path
+    // for the frame until the scope that holds them is destroyed.
+
+    struct Cell
+    {
+        ALObjectPtr symbol;
+        ALObjectPtr value;
+    };
+
+    struct Frame
+    {
+        size_t cells;
+        size_t locals;
+        size_t scopes;
+        size_t dynamic;
+    };
 
     CellStack() { push_frame(); }
 
-    void push_frame() { stacks.emplace_back(1); }
-    void pop_frame() { stacks.pop_back(); }
+    void push_frame()
+    {
+        frames.push_back({ std::size(cells), std::size(cells), std::size(scopes), npos });
+        scopes.push_back(std::size(cells));
+    }
+
+    void pop_frame()
+    {
+        truncate(frames.back().cells);
+        scopes.resize(frames.back().scopes);
+        frames.pop_back();
+    }
+
+    void push_scope() { scopes.push_back(std::size(cells)); }
+
+    void pop_scope()
+    {
+        truncate(scopes.back());
+        scopes.pop_back();
+    }
+
+    void seal_closure() { frames.back().locals = std::size(cells); }
+
+    Frame &current_frame() { return frames.back(); }
+
+    size_t frame_scopes() const { return std::size(scopes) - frames.back().scopes; }
 
-    void push_scope() { stacks.back().emplace_back(); }
-    void pop_scope() { stacks.back().pop_back(); }
+    size_t root_scopes() const { return std::size(frames) > 1 ? frames[1].scopes : std::size(scopes); }
+
+    ALObjectPtr *find(const ALObjectPtr &t_sym)
+    {
+        const auto &frame = frames.back();
+        const auto loc    = t_sym->get_location();
+
+        if (loc != 0 and frame.dynamic == npos)
+        {
+            if (loc == ALObject::GLOBAL_LOCATION)
+            {
+                return scan(t_sym, frame.cells, frame.locals);
+            }
 
-    StackFrame &root_frame() { return stacks.front(); }
-    StackFrame &current_frame() { return stacks.back(); }
-    Scope &current_scope() { return stacks.back().back(); }
+            const auto index = frame.locals + loc - 1;
+            if (index < std::size(cells) and cells[index].symbol == t_sym)
+            {
+                return &cells[index].value;
+            }
+        }
+
+        return scan(t_sym, frame.cells, std::size(cells));
+    }
+
+    bool put(const ALObjectPtr &t_sym, ALObjectPtr t_val)
+    {
+        if (auto cell = scan(t_sym, scopes.back(), std::size(cells)); cell != nullptr)
+        {
+            *cell = std::move(t_val);
+            return false;
+        }
+
+        if (frames.back().dynamic == npos)
+        {
+            frames.back().dynamic = std::size(cells);
+        }
+        cells.push_back({ t_sym, std::move(t_val) });
+        return true;
+    }
+
+    bool bind(const ALObjectPtr &t_sym, ALObjectPtr t_val)
+    {
+        const auto from = std::max(scopes.back(), frames.back().locals);
+        if (auto cell = scan(t_sym, from, std::size(cells)); cell != nullptr)
+        {
+            *cell = std::move(t_val);
+            return false;
+        }
+
+        cells.push_back({ t_sym, std::move(t_val) });
+        return true;
+    }
+
+    auto frame_cells()
+    {
+        const auto offset = static_cast<std::ptrdiff_t>(frames.back().cells);
+        return utility::vector_view<Cell>(std::next(std::begin(cells), offset), std::end(cells));
+    }
+
+    std::vector<Cell> cells;
+    std::vector<size_t> scopes;
+    std::vector<Frame> frames;
+
+  private:
+    ALObjectPtr *scan(const ALObjectPtr &t_sym, size_t t_from, size_t t_to)
+    {
+        for (auto index = t_to; index > t_from; --index)
+        {
+            auto &cell = cells[index - 1];
+            if (cell.symbol->symbol_id() == t_sym->symbol_id())
+            {
+                return &cell.value;
+            }
+        }
+        return nullptr;
+    }
 
-    Stack stacks;
+    void truncate(size_t t_size)
+    {
+        cells.erase(std::next(std::begin(cells), static_cast<std::ptrdiff_t>(t_size)), std::end(cells));
+        if (frames.back().dynamic >= t_size)
+        {
+            frames.back().dynamic = npos;
+        }
+    }
 };
 
 }  // namespace detail
@@ -89,8 +216,18 @@ using ModulePtr = std::shared_ptr<Module>;
 class Module
 {
   public:
+    struct GlobalCell
+    {
+        ALObjectPtr *cell;
+        size_t generation;
+        bool in_root;
+    };
+
+    static constexpr size_t GLOBAL_CACHE_SIZE = 4096;
+
   private:
     detail::CellStack::Scope m_root_scope;
+    FlatMap<SymbolId, GlobalCell> m_global_cache;
     std::unordered_map<std::string, ModulePtr> m_modules;
     std::string m_name;
     std::vector<std::string> m_evals;
@@ -101,9 +238,13 @@ class Module
 
     detail::CellStack::Scope &root_scope() { return m_root_scope; }
 
+    FlatMap<SymbolId, GlobalCell> &global_cache() { return m_global_cache; }
+
     std::vector<std::string> &eval_strings() { return m_evals; }
     std::vector<ALObjectPtr> &eval_objs() { return m_eval_obj; }
 
+    std::unordered_map<std::string, ModulePtr> &modules() { return m_modules; }
+
     void eval_string(std::string t_eval) { m_evals.push_back(std::move(t_eval)); }
     void eval_obj(ALObjectPtr t_obj) { m_eval_obj.push_back(std::move(t_obj)); }
 
@@ -117,12 +258,12 @@ class Module
 
     detail::CellStack::Scope &get_root() { return m_root_scope; }
 
-    inline bool has_symbol(const std::string &t_name) { return m_root_scope.count(t_name) != 0; }
+    inline bool has_symbol(const std::string &t_name) { return m_root_scope.count(symbol_id(t_name)) != 0; }
     inline bool has_module(const std::string &t_name) { return m_modules.count(t_name) != 0; }
 
     inline ALObjectPtr get_symbol(const std::string &t_name)
     {
-        auto sym = m_root_scope.find(t_name);
+        auto sym = m_root_scope.find(symbol_id(t_name));
         if (sym != std::end(m_root_scope))
         {
             return sym->second;
@@ -153,21 +294,33 @@ class Environment
 {
 
   public:
-    static inline std::unordered_map<std::string, ALObjectPtr> g_user_symbols;
-    static inline std::unordered_map<std::string, ALObjectPtr> g_internal_symbols;
-    static inline std::unordered_map<std::string, ALObjectPtr> g_prime_values;
+    static inline FlatMap<SymbolId, ALObjectPtr> g_user_symbols{};
+    static inline FlatMap<SymbolId, ALObjectPtr> g_internal_symbols{};
+    static inline detail::CellStack::Scope g_prime_values{};
     static inline std::unordered_map<std::string, ModuleImport> g_builtin_modules;
 
+    // Bumped whenever a root scope gets a new binding or a binding to a
+    // function changes; invalidates the inline caches of all call sites.
+    static inline size_t g_call_epoch{ 1 };
+
+    static void invalidate_call_sites() { ++g_call_epoch; }
+
 #ifdef ENABLE_STACK_TRACE
 
+    // A call in progress. The callee and the calling form are alive for as
+    // long as the call is, so the frame only keeps their addresses and the
+    // call stack is formatted only when it is printed.
+    struct CallFrame
+    {
+        const ALObject *m_callee;
+        const ALObject *m_form;
+    };
+
     struct CallElement
     {
         std::string m_function{};
-        std::string m_args{};
-        std::string m_file{};
-        bool m_is_prime      = false;
-        size_t m_line        = 0;
-        size_t m_catch_depth = 0;
+        std::optional<SourceLocation> m_location{};
+        bool m_is_prime = false;
     };
 
 #endif
@@ -177,14 +330,14 @@ class Environment
     std::unordered_map<std::string, ModulePtr> m_modules;
     std::unordered_map<std::string, AlispDynModulePtr> m_loaded_modules;
     std::reference_wrapper<Module> m_active_module;
+    std::reference_wrapper<Module> m_main_module;
 
     size_t m_call_depth;
 
     std::vector<std::tuple<size_t, size_t, std::function<void()>>> m_deferred_calls;
 
 #ifdef ENABLE_STACK_TRACE
-    std::vector<CallElement> m_stack_trace;  // name, is_prime
-    size_t m_unwind_defers{ 0 };
+    std::vector<CallFrame> m_call_frames;
 #endif
 
   public:
@@ -202,6 +355,8 @@ class Environment
 
     void activate_module(const std::string &t_name);
 
+    inline void activate_module(Module &t_module) { m_active_module = t_module; }
+
     inline const std::string &current_module() { return m_active_module.get().name(); }
 
     inline Module &current_module_ref() { return m_active_module; }
@@ -224,6 +379,10 @@ class Environment
 
     void put(const ALObjectPtr &t_sym, ALObjectPtr t_val);
 
+    void bind(const ALObjectPtr &t_sym, ALObjectPtr t_val);
+
+    void unload_closure(const ALObjectPtr &t_closure);
+
     void update(const ALObjectPtr &t_sym, ALObjectPtr t_value);
 
     void defer_callback(std::function<void()> t_callback);
@@ -254,7 +413,9 @@ class Environment
 
     inline bool in_function() { return m_call_depth != 0; }
 
-    inline bool in_root() { return (!in_function()) && (std::size(m_stack.root_frame()) == 1); }
+    inline bool in_root() { return (!in_function()) && (m_stack.root_scopes() == 1); }
+
+    Module::GlobalCell &global_cell(const ALObjectPtr &t_sym);
 
     void stack_dump() const;
 
@@ -266,39 +427,40 @@ class Environment
 
 #ifdef ENABLE_STACK_TRACE
 
-    void trace_call(CallElement t_traced) { m_stack_trace.push_back(std::move(t_traced)); }
+    size_t trace_call(const ALObject *t_callee, const ALObject *t_form)
+    {
+        m_call_frames.push_back({ t_callee, t_form });
+        return std::size(m_call_frames) - 1;
+    }
 
-    void trace_unwind()
+    // Drops the frame and every frame above it; the frames may already be
+    // gone if the stack was printed and cleared by a failing call.
+    void trace_unwind(size_t t_frame)
     {
-        if (m_unwind_defers > 0)
+        if (t_frame < std::size(m_call_frames))
         {
-
-            for (size_t i = 0; i < m_unwind_defers; ++i)
-            {
-                if (!std::empty(m_stack_trace))
-                {
-                    m_stack_trace.pop_back();
-                }
-            }
-            m_unwind_defers = 0;
+            m_call_frames.resize(t_frame);
         }
+    }
 
-        if (!std::empty(m_stack_trace))
+    void trace_unwind()
+    {
+        if (!std::empty(m_call_frames))
         {
-            m_stack_trace.pop_back();
+            m_call_frames.pop_back();
             return;
         }
 
         warn::warn_env("Unwinding an empty stack.");
     }
 
-    void defer_unwind() { ++m_unwind_defers; }
-
-    auto &stack() { return m_stack; }
+    std::vector<CallElement> call_stack() const;
 
-    auto get_stack_trace() -> auto & { return m_stack_trace; }
+    auto get_call_frames() -> auto & { return m_call_frames; }
 
 #endif
+
+    auto &stack() { return m_stack; }
 };
 
 
@@ -310,41 +472,20 @@ namespace detail
 struct CallTracer
 {
   public:
-    explicit CallTracer(Environment &t_env) : m_env(t_env), m_traced() {}
-
-    ~CallTracer()
+    CallTracer(Environment &t_env, const ALObject *t_callee, const ALObject *t_form)
+      : m_env(t_env), m_frame(t_env.trace_call(t_callee, t_form))
     {
-        if (m_traced.m_catch_depth == 0)
-        {
-            m_env.trace_unwind();
-        }
-        else
-        {
-            m_env.defer_unwind();
-        }
     }
 
-    void line(ALObject::int_type t_line) { m_traced.m_line = static_cast<size_t>(t_line); }
-
-    void file(ALObject::string_type t_name) { m_traced.m_file = std::move(t_name); }
-
-    void catch_depth(size_t t_catch_depth) { m_traced.m_catch_depth = t_catch_depth; }
-
-    void function_name(std::string t_func, bool t_is_prime = false)
-    {
-        m_traced.m_function = std::move(t_func);
-        m_traced.m_is_prime = t_is_prime;
-
-        m_env.trace_call(m_traced);
-    }
+    ~CallTracer() { m_env.trace_unwind(m_frame); }
 
     void dump()
     {
 
-        if (ALISP_UNLIKELY(!std::empty(m_env.get_stack_trace())))
+        if (ALISP_UNLIKELY(!std::empty(m_env.get_call_frames())))
         {
             m_env.callstack_dump();
-            m_env.get_stack_trace().clear();
+            m_env.get_call_frames().clear();
         }
         else
         {
@@ -356,7 +497,7 @@ struct CallTracer
 
   private:
     Environment &m_env;
-    Environment::CallElement m_traced;
+    size_t m_frame;
 };
 
 #endif
@@ -371,7 +512,7 @@ struct FunctionCall
 
   private:
     Environment &m_env;
-    std::string m_prev_mod;
+    Module *m_prev_mod{ nullptr };
 };
 
 struct ScopePushPop
@@ -411,11 +552,11 @@ struct ModuleChange
 
     ALISP_RAII_OBJECT(ModuleChange);
 
-    const std::string &old_module() const { return m_prev_mod; }
+    const std::string &old_module() const { return m_prev_mod.name(); }
 
   private:
     Environment &m_env;
-    const std::string &m_prev_mod;
+    Module &m_prev_mod;
 };
 
 }  // namespace detail
@@ -19,6 +19,9 @@
 #include <atomic>
 #include <csignal>
 #include <iostream>
+#include <limits>
+#include <optional>
+#include <vector>
 
 #include "alisp/alisp/alisp_common.hpp"
 #include "alisp/alisp/alisp_exception.hpp"
@@ -27,6 +30,11 @@
 namespace alisp
 {
 
+namespace vm
+{
+class VirtualMachine;
+}
+
 namespace eval
 {
 
@@ -35,8 +43,19 @@ namespace detail
 class EvalDepthTrack;
 class CatchTrack;
 class EvaluationLock;
+class FlowScope;
 }  // namespace detail
 
+class ArgumentWindow;
+
+enum class Unwind
+{
+    NONE,
+    RETURN,
+    BREAK,
+    CONTINUE
+};
+
 class Evaluator
 {
   private:
@@ -44,6 +63,7 @@ class Evaluator
     size_t m_eval_depth;
     size_t m_catching_depth;
     parser::ParserBase *m_parser;
+    vm::VirtualMachine *m_vm;
 
     async::AsyncS m_async;
 
@@ -53,6 +73,33 @@ class Evaluator
 
     std::string m_current_file;
 
+    // A return, break or continue that is evaluated as a statement is
+    // propagated by flagging the evaluator instead of throwing. The chains
+    // hold the evaluation depth up to which every form since the enclosing
+    // function (resp. loop) is evaluated as a statement, i.e. a form whose
+    // evaluation is stopped by the flag and whose value is the value of
+    // the statement.
+    static constexpr size_t NO_CHAIN = std::numeric_limits<size_t>::max();
+
+    Unwind m_unwind{ Unwind::NONE };
+    ALObjectPtr m_unwind_value;
+    size_t m_return_chain{ NO_CHAIN };
+    size_t m_loop_chain{ NO_CHAIN };
+
+    // The tail chain holds the depth of the form whose value is the value of
+    // the enclosing function. A call to a function in that position leaves
+    // its callee and arguments here and the enclosing call reuses its frame.
+    size_t m_tail_chain{ NO_CHAIN };
+    ALObjectPtr m_tail_callee;
+    ALObject::list_type m_tail_args;
+
+    // Evaluated arguments live in windows of this stack for the duration of
+    // a call. The windows are viewed in place, so the stack never grows past
+    // its initial capacity; calls that do not fit allocate their arguments.
+    static constexpr size_t VALUE_STACK_SIZE = 16 * 1024;
+
+    std::vector<ALObjectPtr> m_value_stack;
+
     static constexpr std::uint32_t SIGINT_FLAG            = 0x0001;
     static constexpr std::uint32_t ACTIVE_EVALUATION_FLAG = 0x0002;
     static constexpr std::uint32_t SIGTERM_FLAG           = 0x0004;
@@ -65,11 +112,23 @@ class Evaluator
 
     void put_argument(const ALObjectPtr &param, ALObjectPtr arg);
 
+    void bind_argument(const ALObjectPtr &param, ALObjectPtr arg);
+
     ALObjectPtr apply_function(const ALObjectPtr &func, const ALObjectPtr &args);
 
+    ALObjectPtr call_function(const ALObjectPtr &func, const ALObjectPtr &args);
+
     ALObjectPtr apply_macro(const ALObjectPtr &func, const ALObjectPtr &args);
 
-    ALObjectPtr apply_prime(const ALObjectPtr &func, const ALObjectPtr &args, const ALObjectPtr &internal_call = Qnil);
+    ALObjectPtr apply_prime(const ALObjectPtr &func, const ALObjectPtr &args, const CallSiteCache &site);
+
+    CallSiteCache call_site(const ALObjectPtr &obj, const ALObjectPtr &head);
+
+    ALObjectPtr dispatch(const ALObjectPtr &func,
+                         const CallSiteCache &site,
+                         const ALObjectPtr &args,
+                         const ALObjectPtr &obj,
+                         bool evaluated_args);
 
     void new_evaluation();
 
@@ -94,10 +153,24 @@ class Evaluator
     ALObjectPtr eval_string(std::string &t_eval);
 
     ALObjectPtr eval(const ALObjectPtr &obj);
-    ALObjectPtr eval_callable(const ALObjectPtr &callable, const ALObjectPtr &args, const ALObjectPtr &obj = Qnil);
+    ALObjectPtr eval_callable(const ALObjectPtr &callable,
+                              const ALObjectPtr &args,
+                              const ALObjectPtr &obj = Qnil,
+                              bool evaluated_args    = false);
 
     size_t evaluation_depth() const { return m_eval_depth; }
 
+    ALObjectPtr eval_statement(const ALObjectPtr &obj);
+    ALObjectPtr eval_tail(const ALObjectPtr &obj);
+
+    bool start_unwind(Unwind t_kind, ALObjectPtr t_value);
+    Unwind consume_loop_unwind();
+    inline bool is_unwinding() const { return m_unwind != Unwind::NONE; }
+    inline const ALObjectPtr &unwind_value() const { return m_unwind_value; }
+
+    inline void set_vm(vm::VirtualMachine *t_vm) { m_vm = t_vm; }
+    inline vm::VirtualMachine *vm() const { return m_vm; }
+
     void handle_signal(int t_c);
 
     void check_status();
@@ -125,10 +198,29 @@ class Evaluator
     friend detail::EvalDepthTrack;
     friend detail::CatchTrack;
     friend detail::EvaluationLock;
+    friend detail::FlowScope;
+    friend ArgumentWindow;
 
     friend async::AsyncS;
 };
 
+class ArgumentWindow
+{
+  public:
+    ArgumentWindow(Evaluator &t_eval, const ALObjectPtr &t_args);
+    ~ArgumentWindow();
+
+    ALISP_RAII_OBJECT(ArgumentWindow);
+
+    const ALObjectPtr &values() const { return m_values; }
+
+  private:
+    Evaluator &m_eval;
+    size_t m_base;
+    std::optional<ALObject> m_view;
+    ALObjectPtr m_values;
+};
+
 namespace detail
 {
 
@@ -168,6 +260,30 @@ class EvaluationLock
     Evaluator &m_eval;
 };
 
+class FlowScope
+{
+  public:
+    enum class Kind
+    {
+        STATEMENT,
+        FUNCTION,
+        LOOP,
+        BARRIER,
+        TAIL
+    };
+
+    FlowScope(Evaluator &t_eval, Kind t_kind);
+    ~FlowScope();
+
+    ALISP_RAII_OBJECT(FlowScope);
+
+  private:
+    Evaluator &m_eval;
+    size_t m_return_chain;
+    size_t m_loop_chain;
+    size_t m_tail_chain;
+};
+
 }  // namespace detail
 
 }  // namespace eval
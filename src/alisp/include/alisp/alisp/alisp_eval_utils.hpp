@@ -45,10 +45,40 @@ inline ALObjectPtr eval_list(eval::Evaluator *evl, const ALObjectPtr &t_obj, siz
 
     while (start_it != end_it)
     {
-        evl->eval(*start_it);
+        evl->eval_statement(*start_it);
+        if (evl->is_unwinding())
+        {
+            return evl->unwind_value();
+        }
+        start_it = std::next(start_it);
+    }
+    return evl->eval_statement(*end_it);
+}
+
+// Like eval_list but the last form is evaluated in the tail position of
+// the form that evaluates the list.
+inline ALObjectPtr eval_list_tail(eval::Evaluator *evl, const ALObjectPtr &t_obj, size_t t_offset = 0)
+{
+    auto &objects   = *t_obj;
+    const auto hops = static_cast<std::iterator_traits<decltype(std::begin(objects))>::difference_type>(t_offset);
+    auto start_it   = std::next(std::begin(objects), hops);
+    auto end_it     = std::prev(std::end(objects));
+
+    if (start_it > end_it)
+    {
+        return Qt;
+    }
+
+    while (start_it != end_it)
+    {
+        evl->eval_statement(*start_it);
+        if (evl->is_unwinding())
+        {
+            return evl->unwind_value();
+        }
         start_it = std::next(start_it);
     }
-    return evl->eval(*end_it);
+    return evl->eval_tail(*end_it);
 }
 
 template<size_t N> inline ALObjectPtr eval_list_n(eval::Evaluator *evl, const ALObjectPtr &t_obj, size_t t_offset = 0)
@@ -202,7 +232,7 @@ inline auto eval_check(eval::Evaluator *eval, const ALObjectPtr &t_obj, size_t t
 
 inline auto arg_eval(eval::Evaluator *eval, const ALObjectPtr &obj, size_t index)
 {
-    return (obj->prop_exists("--evaled--") ? obj->i(index) : eval->eval(obj->i(index)));
+    return (obj->check_evaled_flag() ? obj->i(index) : eval->eval(obj->i(index)));
 }
 
 }  // namespace alisp
@@ -404,7 +404,10 @@ template<bool should_exit = false> void handle_errors_lippincott()
                      "something.\n"
                   << rang::fg::reset;
         std::cout << '\t' << p_exc.what() << "\n";
-        std::cout << "\tDump: " << dump(p_exc.obj()) << "\n";
+        if (p_exc.obj() != nullptr)
+        {
+            std::cout << "\tDump: " << dump(p_exc.obj()) << "\n";
+        }
     }
     catch (interrupt_error &p_exc)
     {
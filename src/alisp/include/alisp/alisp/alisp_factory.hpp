@@ -25,6 +25,7 @@
 #include <memory>
 
 #include "alisp/alisp/alisp_common.hpp"
+#include "alisp/alisp/alisp_gc.hpp"
 #include "alisp/utility.hpp"
 
 
@@ -69,35 +70,108 @@ struct ALObjectHelper
         }
     }
 
+    // A pointer to an object that is owned by someone else (usually the C++
+    // stack) and outlives every copy of the pointer; it does not allocate.
+    template<typename T> static auto init_ptr_borrowed(T &&val)
+    {
+        if constexpr (USING_SHARED)
+        {
+            return std::shared_ptr<ALObject>(std::shared_ptr<ALObject>(), val);
+        }
+        else
+        {
+            return val;
+        }
+    }
+
     template<typename T> static auto allocate_ptr(T &&) { return nullptr; }
 
+    template<typename... T> static ALObjectPtr allocate(T &&... args)
+    {
+        if constexpr (USING_SHARED)
+        {
+            return std::make_shared<ALObject>(std::forward<T>(args)...);
+        }
+        else
+        {
+#ifdef USE_GC_MEMORY
+            return gc::heap().allocate(std::forward<T>(args)...);
+#else
+            return init_ptr(new ALObject(std::forward<T>(args)...));
+#endif
+        }
+    }
+
   public:
+    // Small integers and characters are preallocated once and shared by
+    // every piece of code that creates them. They are marked as immediate
+    // and must never be mutated.
+    struct Immediates
+    {
+        static constexpr ALObject::int_type MIN_INT  = -128;
+        static constexpr ALObject::int_type MAX_INT  = 1023;
+        static constexpr ALObject::int_type MAX_CHAR = 127;
+
+        std::vector<ALObjectPtr> ints;
+        std::vector<ALObjectPtr> chars;
+
+        Immediates()
+        {
+            ints.reserve(static_cast<size_t>(MAX_INT - MIN_INT + 1));
+            for (auto i = MIN_INT; i <= MAX_INT; ++i)
+            {
+                ints.push_back(allocate(i));
+                ints.back()->set_immediate_flag();
+            }
+
+            chars.reserve(static_cast<size_t>(MAX_CHAR + 1));
+            for (ALObject::int_type i = 0; i <= MAX_CHAR; ++i)
+            {
+                chars.push_back(allocate(i));
+                chars.back()->set_immediate_flag();
+                chars.back()->set_char_flag();
+            }
+        }
+
+        static const Immediates &get()
+        {
+            static const Immediates immediates;
+            return immediates;
+        }
+    };
+
     template<typename T> static auto get(T a) -> typename std::enable_if_t<std::is_integral_v<T>, ALObjectPtr>
     {
         const auto val = static_cast<ALObject::int_type>(a);
-        auto obj       = new ALObject(val);
-
-        return init_ptr(obj);
+        if (Immediates::MIN_INT <= val and val <= Immediates::MAX_INT)
+        {
+            return Immediates::get().ints[static_cast<size_t>(val - Immediates::MIN_INT)];
+        }
+        return allocate(val);
     }
 
     template<typename T> static auto get(T a) -> typename std::enable_if_t<std::is_floating_point_v<T>, ALObjectPtr>
     {
-        return init_ptr(new ALObject(static_cast<ALObject::real_type>(a)));
+        return allocate(static_cast<ALObject::real_type>(a));
     }
 
     template<typename T>
     static auto get(T a) -> typename std::enable_if_t<std::is_constructible_v<std::string, T>, ALObjectPtr>
     {
-        return init_ptr(new ALObject(std::string(a)));
+        return allocate(std::string(a));
     }
 
     template<typename T>
     static auto get(T a, bool) -> typename std::enable_if_t<std::is_constructible_v<std::string, T>, ALObjectPtr>
     {
-        return init_ptr(new ALObject(std::string(a), true));
+        return allocate(std::string(a), true);
     }
 
-    static auto get(std::vector<ALObjectPtr> vec_objs) { return init_ptr(new ALObject(vec_objs)); }
+    static auto get(std::vector<ALObjectPtr> vec_objs) { return allocate(std::move(vec_objs)); }
+
+    static auto get(ALObject::range_type t_range) { return allocate(t_range); }
+
+    static auto get(ALObject::slice_type t_slice) { return allocate(std::move(t_slice)); }
 
     static auto get(ALObjectPtr obj) -> ALObjectPtr { return obj; }
 
@@ -108,7 +182,7 @@ struct ALObjectHelper
 
         (vec_objs.push_back(ALObjectHelper::get(objs)), ...);
 
-        return init_ptr(new ALObject(vec_objs));
+        return allocate(std::move(vec_objs));
     }
 };
 
@@ -125,7 +199,7 @@ template<typename T> inline auto make_symbol(T name, [[maybe_unused]] const std:
 
     auto new_obj = detail::ALObjectHelper::get(std::string(name), true);
 #ifdef ENABLE_OBJECT_DOC
-    new_obj->set_prop("--doc--", detail::ALObjectHelper::get(t_doc));
+    new_obj->set_prop(PropKey::DOC, detail::ALObjectHelper::get(t_doc));
 #endif
     return new_obj;
 }
@@ -140,13 +214,29 @@ template<typename T> inline auto make_char(T value)
 {
     static_assert(std::is_integral_v<T>, "Value must be of integer type");
 
-    auto obj = make_object(static_cast<ALObject::int_type>(value));
+    const auto val = static_cast<ALObject::int_type>(value);
+    if (0 <= val && val <= detail::ALObjectHelper::Immediates::MAX_CHAR)
+    {
+        return detail::ALObjectHelper::Immediates::get().chars[static_cast<size_t>(val)];
+    }
+
+    return make_object(val);
+}
 
-    if (0 <= value && value <= 127)
+// Returns an object that can be modified without affecting the rest of the
+// program; immediate values are copied into a freshly allocated object.
+inline ALObjectPtr make_mutable(ALObjectPtr t_obj)
+{
+    if (!t_obj->check_immediate_flag())
     {
-        obj->set_char_flag();
+        return t_obj;
     }
 
+    auto obj = detail::ALObjectHelper::allocate(t_obj->to_int());
+    if (t_obj->check_char_flag())
+    {
+        obj->set_char_flag();
+    }
     return obj;
 }
 
@@ -175,7 +265,8 @@ inline auto make_list(ALObjectPtr obj)
 inline auto make_doc(ALObjectPtr obj, [[maybe_unused]] const std::string &t_doc = {})
 {
 #ifdef ENABLE_OBJECT_DOC
-    obj->set_prop("--doc--", detail::ALObjectHelper::get(t_doc));
+    obj = make_mutable(std::move(obj));
+    obj->set_prop(PropKey::DOC, detail::ALObjectHelper::get(t_doc));
 #endif
     return obj;
 }
@@ -221,10 +312,10 @@ inline auto make_prime(Prim::func_type t_function, std::string t_name, [[maybe_u
 {
     auto sym = make_object(ALObject::list_type{});
     sym->make_prime(t_function);
-    sym->set_prop("--name--", make_string(std::move(t_name)));
+    sym->set_prop(PropKey::NAME, make_string(std::move(t_name)));
 
 #ifdef ENABLE_OBJECT_DOC
-    sym->set_prop("--doc--", make_string(t_doc));
+    sym->set_prop(PropKey::DOC, make_string(t_doc));
 #endif
 
     return sym;
@@ -250,16 +341,13 @@ inline auto operator"" _sym(const char *t_name)
     return make_symbol(t_name);
 }
 
-inline auto getraw(ALObjectPtr &t_obj)
+inline ALObject *getraw(const ALObjectPtr &t_obj)
 {
-    if constexpr (USING_SHARED)
-    {
-        return t_obj.get();
-    }
-    else
-    {
-        return t_obj;
-    }
+#ifdef USE_MANUAL_MEMORY
+    return t_obj;
+#else
+    return t_obj.get();
+#endif
 }
 
 
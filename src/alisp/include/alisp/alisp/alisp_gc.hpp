@@ -0,0 +1,229 @@
+/*   Alisp - the alisp interpreted language
+     Copyright (C) 2020 Stanislav Arnaudov
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any prior version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along
+ with this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#pragma once
+
+#ifdef USE_GC_MEMORY
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "alisp/alisp/alisp_common.hpp"
+
+#include "alisp/utility/macros.hpp"
+
+namespace alisp
+{
+
+namespace gc
+{
+
+/*
+ * Precise mark and sweep collector for the objects of the interpreter.
+ *
+ * Objects live in the fixed size slots of arena blocks; a new object takes
+ * the last freed slot or the next slot of the current block. Collections
+ * happen only at safepoints - between two top level forms - where no object
+ * is referenced from the C++ stack. Everything reachable from the registered
+ * root sets (environments, virtual machines, async systems, the forms that
+ * are about to be evaluated) or from a permanent object survives. The objects
+ * that exist when the heap is sealed (the built-in symbols, primitives and
+ * everything created while the engine initializes) are permanent.
+ */
+
+class Marker
+{
+  private:
+    std::vector<ALObject *> m_pending;
+
+  public:
+    void mark(ALObject *t_obj)
+    {
+        if (t_obj == nullptr or t_obj->check_mark_flag())
+        {
+            return;
+        }
+        t_obj->set_mark_flag();
+        m_pending.push_back(t_obj);
+    }
+
+    template<typename Container> void mark_values(const Container &t_container)
+    {
+        for (auto &[_, value] : t_container)
+        {
+            mark(value);
+        }
+    }
+
+    void drain()
+    {
+        while (!m_pending.empty())
+        {
+            auto obj = m_pending.back();
+            m_pending.pop_back();
+            obj->visit_references([this](ALObject *t_ref) { mark(t_ref); });
+        }
+    }
+};
+
+class Heap
+{
+  public:
+    using tracer_type = std::function<void(Marker &)>;
+    using pruner_type = std::function<void()>;
+
+    static constexpr size_t BLOCK_OBJECTS = 4096;
+    static constexpr size_t MIN_THRESHOLD = 64 * 1024;
+
+    struct Stats
+    {
+        size_t blocks;
+        size_t live;
+        size_t collections;
+        size_t freed;
+    };
+
+  private:
+    struct alignas(ALObject) Slot
+    {
+        unsigned char storage[sizeof(ALObject)];
+    };
+
+    struct Block
+    {
+        std::unique_ptr<Slot[]> slots{ new Slot[BLOCK_OBJECTS] };
+        std::vector<bool> live = std::vector<bool>(BLOCK_OBJECTS, false);
+    };
+
+    struct RootSet
+    {
+        const void *owner;
+        tracer_type tracer;
+        pruner_type pruner;
+    };
+
+    std::mutex m_lock;
+
+    std::vector<Block> m_blocks;
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> m_free;
+    size_t m_bump{ BLOCK_OBJECTS };
+
+    std::vector<ALObject *> m_permanent;
+    std::vector<RootSet> m_roots;
+    bool m_sealed{ false };
+
+    size_t m_allocated{ 0 };
+    size_t m_threshold{ MIN_THRESHOLD };
+    size_t m_live{ 0 };
+    size_t m_collections{ 0 };
+    size_t m_freed{ 0 };
+
+    ALObject *slot(size_t t_block, size_t t_index)
+    {
+        return std::launder(reinterpret_cast<ALObject *>(m_blocks[t_block].slots[t_index].storage));
+    }
+
+    std::pair<size_t, size_t> next_slot()
+    {
+        if (!m_free.empty())
+        {
+            const auto [block, index] = m_free.back();
+            m_free.pop_back();
+            return { block, index };
+        }
+
+        if (m_bump == BLOCK_OBJECTS)
+        {
+            m_blocks.emplace_back();
+            m_bump = 0;
+        }
+
+        return { std::size(m_blocks) - 1, m_bump++ };
+    }
+
+    template<typename Callable> void for_each_live(Callable &&t_fun)
+    {
+        for (size_t block = 0; block < std::size(m_blocks); ++block)
+        {
+            const auto used = block + 1 == std::size(m_blocks) ? m_bump : BLOCK_OBJECTS;
+            for (size_t index = 0; index < used; ++index)
+            {
+                if (m_blocks[block].live[index])
+                {
+                    t_fun(block, index);
+                }
+            }
+        }
+    }
+
+  public:
+    template<typename... T> ALObject *allocate(T &&... args)
+    {
+        std::lock_guard<std::mutex> guard{ m_lock };
+
+        const auto [block, index] = next_slot();
+        auto obj = new (m_blocks[block].slots[index].storage) ALObject(std::forward<T>(args)...);
+        m_blocks[block].live[index] = true;
+
+        ++m_allocated;
+        ++m_live;
+        return obj;
+    }
+
+    void add_roots(const void *t_owner, tracer_type t_tracer, pruner_type t_pruner = {});
+
+    void remove_roots(const void *t_owner);
+
+    void seal();
+
+    size_t collect();
+
+    void safepoint();
+
+    Stats stats();
+};
+
+Heap &heap();
+
+class Roots
+{
+  public:
+    explicit Roots(const std::vector<ALObjectPtr> &t_objects)
+    {
+        heap().add_roots(this, [&t_objects](Marker &t_marker) {
+            for (auto obj : t_objects)
+            {
+                t_marker.mark(obj);
+            }
+        });
+    }
+
+    ~Roots() { heap().remove_roots(this); }
+
+    ALISP_RAII_OBJECT(Roots);
+};
+
+}  // namespace gc
+
+}  // namespace alisp
+
+#endif
@@ -28,25 +28,32 @@
 #define PRIMITIVE_CAT(a, ...) a##__VA_ARGS__
 #define CAT(a, ...) PRIMITIVE_CAT(a, __VA_ARGS__)
 
-#define DEFSYM(var, sym_name, DOC) \
-    inline auto var =              \
-      env::Environment::g_internal_symbols.insert({ sym_name, make_symbol(sym_name, DOC) }).first->second
+#define DEFSYM(var, sym_name, DOC)                                                        \
+    inline auto var = env::Environment::g_internal_symbols                                \
+                        .insert({ env::symbol_id(sym_name), make_symbol(sym_name, DOC) }) \
+                        .first->second
 
 #define DEFVAR(sym, var, sym_name, value, doc)                                                                        \
-    inline auto sym = env::Environment::g_internal_symbols.insert({ sym_name, make_symbol(sym_name) }).first->second; \
-    inline auto var = env::Environment::g_prime_values.insert({ sym_name, make_doc(value, doc) }).first->second
+    inline auto sym =                                                                                                 \
+      env::Environment::g_internal_symbols.insert({ env::symbol_id(sym_name), make_symbol(sym_name) }).first->second; \
+    inline auto var =                                                                                                 \
+      env::Environment::g_prime_values.insert({ env::symbol_id(sym_name), make_doc(value, doc) }).first->second
 
 
-#define DEFUN_4(name, sym, signature, doc)                                                                      \
-    extern ALObjectPtr F##name(const ALObjectPtr &, env::Environment *, eval::Evaluator *);                     \
-    inline auto Q##name = env::Environment::g_internal_symbols.insert({ sym, make_symbol(sym) }).first->second; \
-    inline auto P##name = env::Environment::g_prime_values.insert({ sym, make_prime(&F##name, sym, doc) }).first->second
+#define DEFUN_4(name, sym, signature, doc)                                                                          \
+    extern ALObjectPtr F##name(const ALObjectPtr &, env::Environment *, eval::Evaluator *);                         \
+    inline auto Q##name =                                                                                           \
+      env::Environment::g_internal_symbols.insert({ env::symbol_id(sym), make_symbol(sym) }).first->second;         \
+    inline auto P##name =                                                                                           \
+      env::Environment::g_prime_values.insert({ env::symbol_id(sym), make_prime(&F##name, sym, doc) }).first->second
 
 
-#define DEFUN_3(name, sym, doc)                                                                                 \
-    extern ALObjectPtr F##name(const ALObjectPtr &, env::Environment *, eval::Evaluator *);                     \
-    inline auto Q##name = env::Environment::g_internal_symbols.insert({ sym, make_symbol(sym) }).first->second; \
-    inline auto P##name = env::Environment::g_prime_values.insert({ sym, make_prime(&F##name, sym, doc) }).first->second
+#define DEFUN_3(name, sym, doc)                                                                                     \
+    extern ALObjectPtr F##name(const ALObjectPtr &, env::Environment *, eval::Evaluator *);                         \
+    inline auto Q##name =                                                                                           \
+      env::Environment::g_internal_symbols.insert({ env::symbol_id(sym), make_symbol(sym) }).first->second;         \
+    inline auto P##name =                                                                                           \
+      env::Environment::g_prime_values.insert({ env::symbol_id(sym), make_prime(&F##name, sym, doc) }).first->second
 
 
 #define GET_DEFUN(_1, _2, _3, _4, NAME, ...) NAME
@@ -149,7 +156,7 @@
 #endif
 
 
-#define AL_EVAL(obj, eval_obj, index) (obj->prop_exists("--evaled--") ? obj->i(index) : eval_obj->eval(obj->i(index)))
+#define AL_EVAL(obj, eval_obj, index) (obj->check_evaled_flag() ? obj->i(index) : eval_obj->eval(obj->i(index)))
 
 #define AL_EVAL_CHECK(name, obj, eval_obj, index, assert) \
     auto name = AL_EVAL(obj, eval_obj, index);            \
@@ -54,47 +54,48 @@ inline void module_defun(env::Module *t_module,
                          ALObjectPtr signature = Qnil,
                          bool managed          = true)
 {
-    auto &new_fun = t_module->get_root().insert({ t_name, make_prime(fun, t_name) }).first->second;
+    auto &new_fun = t_module->get_root().insert({ env::symbol_id(t_name), make_prime(fun, t_name) }).first->second;
     new_fun->set_function_flag();
 
 #ifdef ENABLE_OBJECT_DOC
-    new_fun->set_prop("--doc--", make_string(t_doc));
+    new_fun->set_prop(PropKey::DOC, make_string(t_doc));
 #endif
-    new_fun->set_prop("--name--", make_string(t_name));
-    new_fun->set_prop("--module--", make_string(t_module->name()));
+    new_fun->set_prop(PropKey::NAME, make_string(t_name));
+    new_fun->set_prop(PropKey::MODULE, make_string(t_module->name()));
 
     if (signature != Qnil)
     {
-        new_fun->set_prop("--signature--", signature);
+        new_fun->set_prop(PropKey::SIGNATURE, signature);
+        new_fun->set_arg_bounds(SignatureHandler::compile(signature));
     }
 
     if (managed)
     {
-        new_fun->set_prop("--managed--", Qt);
+        new_fun->set_prop(PropKey::MANAGED, Qt);
     }
 }
 
 inline void module_defvar(env::Module *t_module, std::string t_name, ALObjectPtr val, std::string t_doc = {})
 {
-    auto &new_var = t_module->get_root().insert({ t_name, std::move(val) }).first->second;
+    auto &new_var = t_module->get_root().insert({ env::symbol_id(t_name), make_mutable(std::move(val)) }).first->second;
 
 #ifdef ENABLE_OBJECT_DOC
-    new_var->set_prop("--doc--", make_string(t_doc));
+    new_var->set_prop(PropKey::DOC, make_string(t_doc));
 #endif
-    new_var->set_prop("--name--", make_string(t_name));
-    new_var->set_prop("--module--", make_string(t_module->name()));
+    new_var->set_prop(PropKey::NAME, make_string(t_name));
+    new_var->set_prop(PropKey::MODULE, make_string(t_module->name()));
 }
 
 inline void module_defconst(env::Module *t_module, std::string t_name, ALObjectPtr val, std::string t_doc = {})
 {
-    auto &new_var = t_module->get_root().insert({ t_name, std::move(val) }).first->second;
+    auto &new_var = t_module->get_root().insert({ env::symbol_id(t_name), make_mutable(std::move(val)) }).first->second;
     new_var->set_const_flag();
 
 #ifdef ENABLE_OBJECT_DOC
-    new_var->set_prop("--doc--", make_string(t_doc));
+    new_var->set_prop(PropKey::DOC, make_string(t_doc));
 #endif
-    new_var->set_prop("--module--", make_string(t_module->name()));
-    new_var->set_prop("--name--", make_string(t_name));
+    new_var->set_prop(PropKey::MODULE, make_string(t_module->name()));
+    new_var->set_prop(PropKey::NAME, make_string(t_name));
 }
 
 inline void module_doc(env::Module *t_module, std::string t_doc)
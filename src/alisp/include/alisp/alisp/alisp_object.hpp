@@ -84,6 +84,28 @@ inline auto quote(const ALObjectPtr &t_obj)
     return make_object(Qquote, std::move(t_obj));
 }
 
+// Walks over the elements of a list one by one. Lazy lists (ranges) are not
+// materialized and the list may change while it is being walked.
+class SequenceCursor
+{
+  private:
+    ALObjectPtr m_seq;
+    size_t m_index{ 0 };
+
+  public:
+    explicit SequenceCursor(ALObjectPtr t_seq) : m_seq(std::move(t_seq)) {}
+
+    bool next(ALObjectPtr &t_element)
+    {
+        if (m_index >= m_seq->length())
+        {
+            return false;
+        }
+        t_element = m_seq->element(m_index++);
+        return true;
+    }
+};
+
 
 /*  _     _     _    */
 /* | |   (_)___| |_  */
@@ -369,9 +391,19 @@ inline bool equal(const ALObjectPtr &t_lhs, const ALObjectPtr &t_rhs)
         return false;
     }
 
+    if (t_lhs->is_int())
+    {
+        return t_lhs == t_rhs or t_lhs->to_int() == t_rhs->to_int();
+    }
+
+    if (t_lhs->is_sym())
+    {
+        return t_lhs->symbol_id() == t_rhs->symbol_id();
+    }
+
     return make_visit(
       t_lhs,
-      type(ALObjectType::SYMBOL) or type(ALObjectType::STRING_VALUE) >>=
+      type(ALObjectType::STRING_VALUE) >>=
       [t_rhs](ALObjectPtr t_obj) { return t_obj->to_string().compare(t_rhs->to_string()) == 0; },
       type(ALObjectType::INT_VALUE) >>= [t_rhs](ALObjectPtr t_obj) { return t_obj->to_int() == t_rhs->to_int(); },
       type(ALObjectType::REAL_VALUE) >>= [t_rhs](ALObjectPtr t_obj) { return real_equal(t_obj, t_rhs); },
@@ -386,6 +418,11 @@ inline bool eq(const ALObjectPtr &t_lhs, const ALObjectPtr &t_rhs)
         return false;
     }
 
+    if (t_lhs->is_int())
+    {
+        return t_lhs == t_rhs or t_lhs->to_int() == t_rhs->to_int();
+    }
+
     return make_visit(
       t_lhs,
       type(ALObjectType::INT_VALUE) >>= [t_rhs](ALObjectPtr t_obj) { return t_obj->to_int() == t_rhs->to_int(); },
@@ -479,7 +516,7 @@ inline auto to_string(const ALObjectPtr &t_obj)
 
     return make_visit(
       t_obj,
-      is_function() >>= [](ALObjectPtr obj) { return (obj->get_prop("--name--")->to_string()); },
+      is_function() >>= [](ALObjectPtr obj) { return (obj->get_prop(PropKey::NAME)->to_string()); },
       is_char() >>= [](ALObjectPtr obj) { return (std::string(1, char(obj->to_int()))); },
       type(ALObjectType::INT_VALUE) >>= [](ALObjectPtr obj) { return (std::to_string(obj->to_int())); },
       type(ALObjectType::REAL_VALUE) >>=
@@ -23,16 +23,20 @@
 #include <utility>
 #include <iterator>
 #include <algorithm>
+#include <array>
 #include <numeric>
+#include <unordered_map>
 
 #include "alisp/alisp/alisp_common.hpp"
 #include "alisp/alisp/alisp_env.hpp"
+#include "alisp/alisp/alisp_eval.hpp"
 #include "alisp/alisp/alisp_factory.hpp"
 #include "alisp/alisp/alisp_object.hpp"
 #include "alisp/alisp/alisp_prims.hpp"
 
 #include "alisp/alisp/declarations/math.hpp"
 #include "alisp/alisp/declarations/constants.hpp"
+#include "alisp/alisp/declarations/language_constructs.hpp"
 
 namespace alisp
 {
@@ -40,6 +44,13 @@ namespace alisp
 namespace optimizer
 {
 
+enum class Level
+{
+    NONE,
+    FOLDING,
+    ALGEBRAIC
+};
+
 namespace detail
 {
 
@@ -62,7 +73,7 @@ template<typename... T> struct Optimizer : T...
 
     auto optimize(ALObjectPtr t_list)
     {
-        ((t_list = static_cast<T &>(*this).optimize(std::move(t_list))), ...);
+        ((t_list = plist(t_list) ? static_cast<T &>(*this).optimize(std::move(t_list)) : std::move(t_list)), ...);
         return t_list;
     }
 };
@@ -77,9 +88,10 @@ struct PrimesInlining
         }
 
         auto head = t_list->i(0);
-        if (env::Environment::g_prime_values.count(head->to_string()) > 0)
+        if (auto it = env::Environment::g_prime_values.find(head->symbol_id());
+            it != std::end(env::Environment::g_prime_values))
         {
-            t_list->children()[0] = env::Environment::g_prime_values.at(head->to_string());
+            t_list->children()[0] = it->second;
             return t_list;
         }
 
@@ -91,16 +103,12 @@ struct DeadCode
 {
     template<size_t start = 0, size_t off = 0> void remove_consts(ALObjectPtr t_list)
     {
-        if (!plist(t_list)) return;
+        if (!plist(t_list) or std::size(*t_list) <= start + off) return;
 
-        for (size_t i = start; i < std::size(*t_list) - off; ++i)
-        {
-            if (is_const(t_list->i(i)))
-            {
-                t_list->children().erase(std::remove(t_list->begin(), t_list->end(), t_list->i(i)),
-                                         t_list->children().end());
-            }
-        }
+        auto &children   = t_list->children();
+        const auto first = std::next(std::begin(children), static_cast<std::ptrdiff_t>(start));
+        const auto last  = std::prev(std::end(children), static_cast<std::ptrdiff_t>(off));
+        children.erase(std::remove_if(first, last, is_const), last);
     }
 
     auto optimize(ALObjectPtr t_list)
@@ -138,7 +146,7 @@ struct If
 {
     auto optimize(ALObjectPtr t_list)
     {
-        if (!(std::size(*t_list) > 1 && (eq(t_list->i(0), Qif) || eq(t_list->i(0), Pif))))
+        if (!(std::size(*t_list) > 2 && (eq(t_list->i(0), Qif) || eq(t_list->i(0), Pif))))
         {
             return t_list;
         }
@@ -215,94 +223,488 @@ struct Unless
     }
 };
 
-struct ConstantFolding
+enum class Operands
+{
+    ANY,
+    NUMBERS
+};
+
+// The primes whose value depends only on their arguments and that do not
+// modify them. A call to one of them with constant arguments is evaluated
+// once, while optimizing.
+inline const std::unordered_map<std::string, Operands> &pure_primes()
+{
+    static const std::unordered_map<std::string, Operands> primes{
+        { "+", Operands::NUMBERS },
+        { "-", Operands::NUMBERS },
+        { "*", Operands::NUMBERS },
+        { "/", Operands::NUMBERS },
+        { "mod", Operands::NUMBERS },
+        { "pow", Operands::NUMBERS },
+        { "round", Operands::NUMBERS },
+        { "min", Operands::NUMBERS },
+        { "max", Operands::NUMBERS },
+        { "<", Operands::NUMBERS },
+        { "<=", Operands::NUMBERS },
+        { ">", Operands::NUMBERS },
+        { ">=", Operands::NUMBERS },
+        { "==", Operands::NUMBERS },
+        { "!=", Operands::NUMBERS },
+        { "<<", Operands::NUMBERS },
+        { ">>", Operands::NUMBERS },
+        { "or*", Operands::NUMBERS },
+        { "and*", Operands::NUMBERS },
+        { "xor*", Operands::NUMBERS },
+        { "inv*", Operands::NUMBERS },
+        { "and", Operands::ANY },
+        { "or", Operands::ANY },
+        { "not", Operands::ANY },
+        { "string-equals", Operands::ANY },
+        { "string-less", Operands::ANY },
+        { "string-contains", Operands::ANY },
+        { "string-endswith", Operands::ANY },
+        { "string-startswith", Operands::ANY },
+        { "string-length", Operands::ANY },
+        { "string-find", Operands::ANY },
+        { "char-isalpha", Operands::ANY },
+        { "char-isdigit", Operands::ANY },
+    };
+    return primes;
+}
+
+inline const Operands *pure_call(const ALObjectPtr &t_list)
+{
+    if (!(plist(t_list) && std::size(*t_list) > 0))
+    {
+        return nullptr;
+    }
+
+    const auto &head = t_list->i(0);
+    const auto name  = psym(head) ? head->to_string()
+                                  : pprime(head) ? head->get_prop(PropKey::NAME)->to_string() : std::string{};
+
+    const auto it = pure_primes().find(name);
+    return it != std::end(pure_primes()) ? &it->second : nullptr;
+}
+
+// The list of a binding form that names its variables (the parameters of a
+// function or the bindings of a let); apart from the initial values of the
+// variables it is not code.
+inline ALObjectPtr bindings(const ALObjectPtr &t_list)
+{
+    if (!(std::size(*t_list) > 1))
+    {
+        return nullptr;
+    }
+
+    const auto &head = t_list->i(0);
+    if (oreq(head, Qlet, Plet, Qletx, Pletx, Qlambda, Plambda, Qdolist, Pdolist, Qdotimes, Pdotimes))
+    {
+        return plist(t_list->i(1)) ? t_list->i(1) : nullptr;
+    }
+
+    if (std::size(*t_list) > 2 and oreq(head, Qdefun, Pdefun, Qdefmacro, Pdefmacro))
+    {
+        return plist(t_list->i(2)) ? t_list->i(2) : nullptr;
+    }
+
+    return nullptr;
+}
+
+// Calls the function with each variable that a binding form introduces,
+// either a symbol or a (symbol initial-value) list.
+template<typename Callable> inline void for_each_binding(const ALObjectPtr &t_list, Callable &&t_fun)
 {
-    template<typename ValueType,
-             ALObject::list_type::difference_type offset = 1,
-             typename FoldOperation,
-             typename Check,
-             typename Init>
-    auto fold(ALObjectPtr t_list, FoldOperation oper, Check check, Init init_val)
+    const auto list = bindings(t_list);
+    if (list == nullptr)
+    {
+        return;
+    }
+
+    if (oreq(t_list->i(0), Qdolist, Pdolist, Qdotimes, Pdotimes))
+    {
+        t_fun(list);
+        return;
+    }
+
+    for (auto &binding : list->children())
     {
+        t_fun(binding);
+    }
+}
 
-        using typ =
-          std::conditional_t<std::is_same_v<ValueType, ALObject::int_type>, ALObject::int_type, ALObject::real_type>;
+struct ConstantPropagation
+{
+    std::unordered_map<std::string, ALObjectPtr> constants;
+    size_t shadowed{ 0 };
 
-        std::vector<typ> new_values{};
+    void define(const ALObjectPtr &t_form)
+    {
+        if (std::size(*t_form) > 2 and oreq(t_form->i(0), Qdefconst, Pdefconst) and psym(t_form->i(1))
+            and is_const(t_form->i(2)) and !pstring(t_form->i(2)))
+        {
+            constants[t_form->i(1)->to_string()] = t_form->i(2);
+        }
+    }
 
-        const auto const_count = std::count_if(std::begin(*t_list) + offset, std::end(*t_list), check);
+    bool binds_constant(const ALObjectPtr &t_form) const
+    {
+        bool binds = false;
+        for_each_binding(t_form, [&](const ALObjectPtr &binding) {
+            const auto &name = plist(binding) && std::size(*binding) > 0 ? binding->i(0) : binding;
+            binds            = binds or (psym(name) and constants.count(name->to_string()) > 0);
+        });
+        return binds;
+    }
 
-        if (const_count <= 1)
+    auto optimize(ALObjectPtr t_list)
+    {
+        if (constants.empty() or shadowed > 0 or pure_call(t_list) == nullptr)
         {
-            return;
+            return t_list;
         }
-        auto end = std::remove_if(std::begin(*t_list) + offset, std::end(*t_list), [&](auto el) {
-            if (check(el))
+
+        for (auto it = std::next(std::begin(t_list->children())); it != std::end(t_list->children()); ++it)
+        {
+            if (!psym(*it))
             {
-                if constexpr (std::is_same_v<ValueType, ALObject::int_type>)
-                {
-                    new_values.push_back(el->to_int());
-                }
-                else
-                {
-                    new_values.push_back(el->to_real());
-                }
-                return true;
+                continue;
             }
 
+            if (const auto constant = constants.find((*it)->to_string()); constant != std::end(constants))
+            {
+                *it = constant->second;
+            }
+        }
+
+        return t_list;
+    }
+};
+
+struct ConstantFolding
+{
+    eval::Evaluator *evaluator{ nullptr };
+
+    static bool foldable(const ALObjectPtr &t_list, Operands t_operands)
+    {
+        const auto first = std::next(std::begin(*t_list));
+        const auto last  = std::end(*t_list);
+
+        if (!std::all_of(first, last, is_const))
+        {
             return false;
-        });
-        t_list->children().erase(end, t_list->children().end());
-        typ sum = static_cast<typ>(std::accumulate(new_values.begin(), new_values.end(), init_val, oper));
+        }
+
+        if (t_operands == Operands::ANY)
+        {
+            return true;
+        }
 
-        if constexpr (std::is_same_v<ValueType, ALObject::int_type>)
+        if (!std::all_of(first, last, [](const ALObjectPtr &el) { return pint(el) or preal(el); }))
         {
+            return false;
+        }
 
-            t_list->children().push_back(make_int(sum));
+        // Integer division by zero, shifts past the width of an integer and
+        // the single argument forms of - and / are left to fail (or not) at
+        // run time.
+        const auto &head = t_list->i(0);
+        if (oreq(head, Qminus, Pminus, Qdev, Pdev) and std::size(*t_list) < 3)
+        {
+            return false;
         }
-        else
+
+        if (oreq(head, Qdev, Pdev, Qmod, Pmod))
         {
-            t_list->children().push_back(make_real(sum));
+            return std::none_of(std::next(first), last, [](const ALObjectPtr &el) { return el->to_real() == 0; });
         }
+
+        if (oreq(head, Qleftshift, Pleftshift, Qrightshift, Prightshift))
+        {
+            return std::size(*t_list) == 3 and pint(t_list->i(2)) and 0 <= t_list->i(2)->to_int()
+                   and t_list->i(2)->to_int() < 64;
+        }
+
+        return true;
     }
 
     auto optimize(ALObjectPtr t_list)
     {
-        if (!(std::size(*t_list) > 1))
+        const auto operands = pure_call(t_list);
+        if (evaluator == nullptr or operands == nullptr or !foldable(t_list, *operands))
+        {
+            return t_list;
+        }
+
+        try
+        {
+            // Strings are not shared as some primes modify their arguments.
+            if (auto value = evaluator->eval(t_list); is_const(value) and !pstring(value))
+            {
+                return value;
+            }
+        }
+        catch (const std::exception &)
+        {
+            // The error is raised again when the form is evaluated.
+        }
+
+        return t_list;
+    }
+};
+
+struct Algebraic
+{
+    bool enabled{ false };
+
+    // Combines the integer constants among the arguments from the given
+    // offset on into a single one. This assumes that the other arguments
+    // are integers as well.
+    template<typename Operation>
+    void reassociate(const ALObjectPtr &t_list, Operation oper, ALObject::int_type t_identity, size_t t_offset)
+    {
+        auto &children   = t_list->children();
+        const auto first = std::next(std::begin(children), static_cast<std::ptrdiff_t>(t_offset));
+
+        if (std::size(children) <= t_offset or std::any_of(std::next(std::begin(children)), std::end(children), preal))
+        {
+            return;
+        }
+
+        auto value   = t_identity;
+        size_t count = 0;
+        auto end     = std::remove_if(first, std::end(children), [&](const ALObjectPtr &el) {
+            if (!pint(el))
+            {
+                return false;
+            }
+            value = oper(value, el->to_int());
+            ++count;
+            return true;
+        });
+
+        if (count == 0)
+        {
+            return;
+        }
+
+        children.erase(end, std::end(children));
+        if (value != t_identity or std::size(children) == 1)
+        {
+            children.push_back(make_int(value));
+        }
+    }
+
+    auto optimize(ALObjectPtr t_list)
+    {
+        if (!enabled or std::size(*t_list) < 3)
         {
             return t_list;
         }
 
         if (oreq(t_list->i(0), Qplus, Pplus))
         {
-            fold<ALObject::int_type>(t_list, std::plus<int>(), pint, 0);
+            reassociate(t_list, std::plus<ALObject::int_type>(), 0, 1);
         }
 
         if (oreq(t_list->i(0), Qmultiply, Pmultiply))
         {
-            fold<ALObject::int_type>(t_list, std::multiplies<int>(), pint, 1);
+            reassociate(t_list, std::multiplies<ALObject::int_type>(), 1, 1);
+        }
+
+        if (oreq(t_list->i(0), Qminus, Pminus))
+        {
+            reassociate(t_list, std::plus<ALObject::int_type>(), 0, 2);
+        }
+
+        return t_list;
+    }
+};
+
+struct Inlining
+{
+    // The number of atoms in the body of a function up to which the
+    // function is inlined.
+    static constexpr size_t MAX_SIZE = 32;
+
+    std::unordered_map<std::string, ALObjectPtr> functions;
+    std::unordered_map<std::string, size_t> definitions;
+    std::unordered_map<std::string, size_t> references;
+    size_t renamed{ 0 };
+
+    // Counts the definitions of each function and the references to each
+    // name that are not calls; a function that is defined more than once
+    // or that is referred to by name could be replaced at run time.
+    void scan(const ALObjectPtr &t_obj)
+    {
+        const bool defun = std::size(*t_obj) > 1 and oreq(t_obj->i(0), Qdefun, Pdefun) and psym(t_obj->i(1));
+        if (defun)
+        {
+            ++definitions[t_obj->i(1)->to_string()];
+        }
+
+        for (size_t i = 0; i < std::size(*t_obj); ++i)
+        {
+            const auto &el = t_obj->i(i);
+            if (plist(el))
+            {
+                scan(el);
+            }
+            else if (psym(el) and i > (defun ? 1u : 0u))
+            {
+                ++references[el->to_string()];
+            }
         }
+    }
+
+    static bool prime_head(const ALObjectPtr &t_head)
+    {
+        // set looks a variable up by a quoted name, which is not renamed.
+        static const std::array<std::string, 8> escaping{ "return", "break",    "continue", "eval",
+                                                          "defun",  "defmacro", "defvar",   "set" };
+
+        const auto name = psym(t_head) ? t_head->to_string()
+                                       : pprime(t_head) ? t_head->get_prop(PropKey::NAME)->to_string() : std::string{};
+
+        return env::Environment::g_prime_values.count(env::symbol_id(name)) > 0
+               and std::find(std::begin(escaping), std::end(escaping), name) == std::end(escaping);
+    }
 
-        if (oreq(t_list->i(0), Qminus, Pminus) and pint(t_list->i(1)))
+    // A body can be inlined if it only calls primes that do not leave the
+    // function and it refers to no variables besides the parameters.
+    static bool inlinable(const ALObjectPtr &t_obj, const ALObjectPtr &t_params, size_t &t_size)
+    {
+        if (!plist(t_obj))
         {
-            fold<ALObject::int_type, 2>(t_list, std::minus<int>(), pint, t_list->i(1)->to_int());
+            const auto is_param = [&](const ALObjectPtr &param) { return eq(param, t_obj); };
+            return ++t_size <= MAX_SIZE
+                   and (!psym(t_obj) or eq(t_obj, Qt) or eq(t_obj, Qnil) or t_obj->to_string()[0] == ':'
+                        or std::any_of(std::begin(*t_params), std::end(*t_params), is_param));
         }
 
-        if (oreq(t_list->i(0), Qdev, Pdev) and pint(t_list->i(1)))
+        if (std::size(*t_obj) > 0 and oreq(t_obj->i(0), Qquote, Pquote))
         {
-            fold<ALObject::int_type, 2>(t_list, std::divides<int>(), pint, t_list->i(1)->to_int());
+            return ++t_size <= MAX_SIZE;
         }
 
+        if (std::size(*t_obj) == 0 or !prime_head(t_obj->i(0)))
+        {
+            return false;
+        }
 
-        return t_list;
+        return std::all_of(std::next(std::begin(*t_obj)), std::end(*t_obj), [&](const ALObjectPtr &el) {
+            return inlinable(el, t_params, t_size);
+        });
+    }
+
+    void declare(const ALObjectPtr &t_form)
+    {
+        if (!(std::size(*t_form) > 3 and oreq(t_form->i(0), Qdefun, Pdefun) and psym(t_form->i(1))
+              and (plist(t_form->i(2)) or eq(t_form->i(2), Qnil))))
+        {
+            return;
+        }
+
+        const auto &name  = t_form->i(1)->to_string();
+        const auto params = plist(t_form->i(2)) ? t_form->i(2) : make_list();
+        const auto first  = std::size(*t_form) > 4 and pstring(t_form->i(3)) ? 4u : 3u;
+
+        const auto plain = [](const ALObjectPtr &param) { return psym(param) and param->to_string()[0] != '&'; };
+        if (definitions[name] != 1 or references[name] > 0
+            or !std::all_of(std::begin(*params), std::end(*params), plain))
+        {
+            return;
+        }
+
+        auto function = make_list(params);
+        size_t size   = 0;
+        for (size_t i = first; i < std::size(*t_form); ++i)
+        {
+            if (!inlinable(t_form->i(i), params, size))
+            {
+                return;
+            }
+            function->children().push_back(t_form->i(i));
+        }
+
+        functions[name] = function;
+    }
+
+    static ALObjectPtr rename(const ALObjectPtr &t_obj, const std::unordered_map<std::string, ALObjectPtr> &t_names)
+    {
+        if (plist(t_obj) and !pprime(t_obj))
+        {
+            if (std::size(*t_obj) > 0 and oreq(t_obj->i(0), Qquote, Pquote))
+            {
+                return t_obj;
+            }
+
+            auto copy = make_list();
+            for (auto &el : *t_obj)
+            {
+                copy->children().push_back(rename(el, t_names));
+            }
+            return copy;
+        }
+
+        if (psym(t_obj))
+        {
+            if (const auto it = t_names.find(t_obj->to_string()); it != std::end(t_names))
+            {
+                return it->second;
+            }
+        }
+
+        return t_obj;
+    }
+
+    auto optimize(ALObjectPtr t_list)
+    {
+        if (functions.empty() or std::size(*t_list) == 0 or !psym(t_list->i(0)))
+        {
+            return t_list;
+        }
+
+        const auto it = functions.find(t_list->i(0)->to_string());
+        if (it == std::end(functions) or std::size(*it->second->i(0)) != std::size(*t_list) - 1)
+        {
+            return t_list;
+        }
+
+        // (f a b) becomes (let ((x a) (y b)) body) with fresh names for the
+        // parameters.
+        const auto &params = it->second->i(0);
+        std::unordered_map<std::string, ALObjectPtr> names;
+        auto bindings = make_list();
+        for (size_t i = 0; i < std::size(*params); ++i)
+        {
+            auto name = make_symbol(params->i(i)->to_string() + "@" + std::to_string(++renamed));
+            names.insert({ params->i(i)->to_string(), name });
+            bindings->children().push_back(make_list(name, t_list->i(i + 1)));
+        }
+
+        auto form = make_list(Qlet, bindings);
+        for (auto body = std::next(std::begin(*it->second)); body != std::end(*it->second); ++body)
+        {
+            form->children().push_back(rename(*body, names));
+        }
+
+        return form;
     }
 };
 
 }  // namespace detail
 
-typedef detail::
-  Optimizer<detail::If, detail::When, detail::Unless, detail::ConstantFolding, detail::DeadCode, detail::PrimesInlining>
-    PipelineOptimizer;
+typedef detail::Optimizer<detail::Inlining,
+                          detail::ConstantPropagation,
+                          detail::ConstantFolding,
+                          detail::Algebraic,
+                          detail::If,
+                          detail::When,
+                          detail::Unless,
+                          detail::DeadCode,
+                          detail::PrimesInlining>
+  PipelineOptimizer;
 
 class MainOptimizer
 {
@@ -312,10 +714,12 @@ class MainOptimizer
     ALObjectPtr do_optimize(const ALObjectPtr &t_obj);
 
   public:
-    MainOptimizer() : m_opt() {}
-
+    explicit MainOptimizer(eval::Evaluator &t_eval) : m_opt() { m_opt.evaluator = &t_eval; }
 
-    void optimize(std::vector<ALObjectPtr> &t_objs);
+    // The optimizations of the FOLDING level do not change the result of a
+    // program. ALGEBRAIC additionally reorders arithmetic on the assumption
+    // that its operands are integers.
+    void optimize(std::vector<ALObjectPtr> &t_objs, Level t_level = Level::FOLDING);
 };
 
 }  // namespace optimizer
@@ -138,6 +138,7 @@ template<class Environment> class ALParser : public ParserBase
     detail::Position position;
     size_t depth;
     std::string m_file;
+    std::uint32_t m_file_id{ 0 };
     std::string m_input;
 
     Environment &env;
@@ -1029,7 +1030,9 @@ template<class Environment> class ALParser : public ParserBase
 
         ALObject::list_type objs;
 #ifdef ENABLE_LINE_TRACE
-        const auto line = position.line;
+        const SourceLocation location{ m_file_id,
+                                       static_cast<std::uint32_t>(position.line),
+                                       static_cast<std::uint32_t>(position.col) };
 #endif
         while (true)
         {
@@ -1073,8 +1076,7 @@ template<class Environment> class ALParser : public ParserBase
 
         auto new_list = make_object(objs);
 #ifdef ENABLE_LINE_TRACE
-        new_list->set_prop("--line--", make_int(line));
-        new_list->set_prop("--file--", make_string(m_file));
+        SourceMap::add(getraw(new_list), location);
 #endif
         return new_list;
     }
@@ -1160,9 +1162,10 @@ template<class Environment> class ALParser : public ParserBase
         const auto end   = begin == nullptr ? nullptr : begin + input.size();
         this->position   = detail::Position(begin, end);
 
-        m_file  = file_name;
-        m_input = input;
-        depth   = 0;
+        m_file    = file_name;
+        m_file_id = SourceMap::file_id(file_name);
+        m_input   = input;
+        depth     = 0;
 
         if (*position == '#' && *(position + 1) == '!')
         {
@@ -102,7 +102,7 @@ template<typename Callalble_In_1> auto operator!(match<Callalble_In_1> t_match)
 
 template<size_t N, class... Matches, class... Checks>
 auto visit_match_impl([[maybe_unused]] const ALObjectPtr &obj,
-                      [[maybe_unused]] std::tuple<pattern_entry<Checks, Matches>...> patterns)
+                      [[maybe_unused]] std::tuple<pattern_entry<Checks, Matches>...> &patterns)
   -> std::common_type_t<std::invoke_result_t<Matches, const ALObjectPtr &>...>
 {
 
@@ -0,0 +1,49 @@
+/*   Alisp - the alisp interpreted language
+     Copyright (C) 2020 Stanislav Arnaudov
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any prior version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along
+ with this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#pragma once
+
+#include <string>
+
+#include "alisp/alisp/alisp_common.hpp"
+#include "alisp/alisp/alisp_env.hpp"
+
+namespace alisp
+{
+
+namespace env
+{
+
+/*
+ * Lexical addressing of the local variables of a function. The parameters
+ * and the variables bound through let, let*, dolist and dotimes in the body
+ * are replaced by fresh symbols that carry their slot in the frame of the
+ * function. Every reference to them is rewritten to point to the same symbol
+ * so that the environment can read the variable with a single indexed load.
+ * References to names that are not bound in the function get a marker that
+ * lets the environment skip the frame and go straight to the cached global
+ * cells. Code that is not evaluated in the frame of the function (quoted
+ * data, macro arguments, nested lambdas) is left untouched.
+ */
+void resolve_function(Environment &t_env,
+                      const ALObjectPtr &t_params,
+                      const ALObjectPtr &t_body,
+                      const std::string &t_name = {});
+
+}  // namespace env
+
+}  // namespace alisp
@@ -291,43 +291,82 @@ struct SignatureHandler
     static inline const std::unordered_map<ALObject *,
                                            std::function<void(ALObjectPtr, size_t, ALObjectPtr, ALObjectPtr)>>
       signature_functions = {
-          { Qor_arg.get(), &signature_or },   { Qand_arg.get(), &signature_and }, { Qnot_arg.get(), &signature_not },
-          { Qmax_size_arg.get(), &size_max }, { Qmin_size_arg.get(), &size_min }, { Qsize_arg.get(), &size_match },
+          { getraw(Qor_arg), &signature_or },        { getraw(Qand_arg), &signature_and },
+          { getraw(Qnot_arg), &signature_not },      { getraw(Qmax_size_arg), &size_max },
+          { getraw(Qmin_size_arg), &size_min },      { getraw(Qsize_arg), &size_match },
 
 
       };
 
     static inline const std::unordered_map<ALObject *, std::function<void(ALObjectPtr, size_t, ALObjectPtr)>>
       signature_assertions = {
-          { Qint.get(), &assert_int<size_t, ALObjectPtr> },
-          { Qdouble.get(), &assert_number<size_t, ALObjectPtr> },
-          { Qstring.get(), &assert_string<size_t, ALObjectPtr> },
-          { Qint.get(), &assert_int<size_t, ALObjectPtr> },
-          { Qlist_arg.get(), &assert_list<size_t, ALObjectPtr> },
-          { Qsym_arg.get(), &assert_symbol<size_t, ALObjectPtr> },
-          { Qchar_arg.get(), &assert_char<size_t, ALObjectPtr> },
-          { Qreal_arg.get(), &assert_real<size_t, ALObjectPtr> },
-          { Qnumber_arg.get(), &assert_number<size_t, ALObjectPtr> },
-          { Qnumbers_arg.get(), &assert_numbers<size_t, ALObjectPtr> },
-          { Qfunction_arg.get(), &assert_function<size_t, ALObjectPtr> },
-          { Qfile_arg.get(), &assert_file<size_t, ALObjectPtr> },
-          { Qstream_arg.get(), &assert_stream<size_t, ALObjectPtr> },
-          { Qmemory_arg.get(), &assert_memory<size_t, ALObjectPtr> },
-          { Qbyte_arg.get(), &assert_byte<size_t, ALObjectPtr> },
-          { Qbytearray_arg.get(), &assert_byte_array<size_t, ALObjectPtr> },
-          { Qany_arg.get(), &ignore },
+          { getraw(Qint), &assert_int<size_t, ALObjectPtr> },
+          { getraw(Qdouble), &assert_number<size_t, ALObjectPtr> },
+          { getraw(Qstring), &assert_string<size_t, ALObjectPtr> },
+          { getraw(Qint), &assert_int<size_t, ALObjectPtr> },
+          { getraw(Qlist_arg), &assert_list<size_t, ALObjectPtr> },
+          { getraw(Qsym_arg), &assert_symbol<size_t, ALObjectPtr> },
+          { getraw(Qchar_arg), &assert_char<size_t, ALObjectPtr> },
+          { getraw(Qreal_arg), &assert_real<size_t, ALObjectPtr> },
+          { getraw(Qnumber_arg), &assert_number<size_t, ALObjectPtr> },
+          { getraw(Qnumbers_arg), &assert_numbers<size_t, ALObjectPtr> },
+          { getraw(Qfunction_arg), &assert_function<size_t, ALObjectPtr> },
+          { getraw(Qfile_arg), &assert_file<size_t, ALObjectPtr> },
+          { getraw(Qstream_arg), &assert_stream<size_t, ALObjectPtr> },
+          { getraw(Qmemory_arg), &assert_memory<size_t, ALObjectPtr> },
+          { getraw(Qbyte_arg), &assert_byte<size_t, ALObjectPtr> },
+          { getraw(Qbytearray_arg), &assert_byte_array<size_t, ALObjectPtr> },
+          { getraw(Qany_arg), &ignore },
       };
 
   public:
+    // Computes the number of arguments that a call must provide. The type
+    // elements of the signature are checked by the primitives themselves.
+    static ArgBounds compile(const ALObjectPtr &signature)
+    {
+        ArgBounds bounds;
+        bounds.max   = 0;
+        bounds.empty = signature->length() == 0;
+
+        bool opt  = false;
+        bool rest = false;
+        for (auto &element : *signature)
+        {
+            bounds.well_formed = true;
+            if (element == Qoptional)
+            {
+                opt                = true;
+                bounds.well_formed = false;
+            }
+            else if (element == Qrest)
+            {
+                rest               = true;
+                bounds.well_formed = false;
+            }
+            else if (rest)
+            {
+                bounds.max = ArgBounds::UNBOUNDED;
+                break;
+            }
+            else
+            {
+                bounds.min += opt ? 0 : 1;
+                ++bounds.max;
+            }
+        }
+
+        return bounds;
+    }
+
     static void handle_signature_element(ALObjectPtr element, ALObjectPtr arg, size_t cnt, ALObjectPtr signature)
     {
         if (plist(element))
         {
-            signature_functions.at(element->i(0).get())(arg, cnt++, signature, splice(element, 1));
+            signature_functions.at(getraw(element->i(0)))(arg, cnt++, signature, splice(element, 1));
         }
         else
         {
-            signature_assertions.at(element.get())(arg, cnt++, signature);
+            signature_assertions.at(getraw(element))(arg, cnt++, signature);
         }
     }
 };
@@ -44,18 +44,19 @@ inline void module_define_function(env::Module *t_module,
 
     NameValidator::validate_object_name(name);
 
-    AL_CHECK(if (scope.count(name)) { throw environment_error("Function alredy exists: " + name); });
+    AL_CHECK(if (scope.count(t_sym->symbol_id())) { throw environment_error("Function alredy exists: " + name); });
 
     auto new_fun = make_object(t_params, t_body);
     new_fun->set_function_flag();
-    new_fun->set_prop("--module--", make_string(t_module->name()));
-    new_fun->set_prop("--name--", make_string(name));
+    new_fun->set_prop(PropKey::MODULE, make_string(t_module->name()));
+    new_fun->set_module(t_module);
+    new_fun->set_prop(PropKey::NAME, make_string(name));
 
 #ifdef ENABLE_OBJECT_DOC
-    new_fun->set_prop("--doc--", make_string(t_doc));
+    new_fun->set_prop(PropKey::DOC, make_string(t_doc));
 #endif
 
-    scope.insert({ name, new_fun });
+    scope.insert({ t_sym->symbol_id(), new_fun });
 }
 
 inline void
@@ -68,14 +69,15 @@ inline void
 
     NameValidator::validate_object_name(name);
 
-    AL_CHECK(if (scope.count(name)) { throw environment_error("Variable alredy exists: " + name); });
-    t_value->set_prop("--module--", make_string(t_module->name()));
+    AL_CHECK(if (scope.count(t_sym->symbol_id())) { throw environment_error("Variable alredy exists: " + name); });
+    t_value = make_mutable(std::move(t_value));
+    t_value->set_prop(PropKey::MODULE, make_string(t_module->name()));
 
 #ifdef ENABLE_OBJECT_DOC
-    t_value->set_prop("--doc--", make_string(t_doc));
+    t_value->set_prop(PropKey::DOC, make_string(t_doc));
 #endif
 
-    scope.insert({ name, t_value });
+    scope.insert({ t_sym->symbol_id(), t_value });
 }
 
 inline void module_define_macro(env::Module *t_module,
@@ -91,19 +93,20 @@ inline void module_define_macro(env::Module *t_module,
 
     NameValidator::validate_object_name(name);
 
-    AL_CHECK(if (scope.count(name)) { throw environment_error("Function alredy exists: " + name); });
+    AL_CHECK(if (scope.count(t_sym->symbol_id())) { throw environment_error("Function alredy exists: " + name); });
 
     auto new_fun = make_object(t_params, t_body);
     new_fun->set_function_flag();
     new_fun->set_macro_flag();
-    new_fun->set_prop("--module--", make_string(t_module->name()));
-    new_fun->set_prop("--name--", make_string(name));
+    new_fun->set_prop(PropKey::MODULE, make_string(t_module->name()));
+    new_fun->set_module(t_module);
+    new_fun->set_prop(PropKey::NAME, make_string(name));
 
 #ifdef ENABLE_OBJECT_DOC
-    new_fun->set_prop("--doc--", make_string(t_doc));
+    new_fun->set_prop(PropKey::DOC, make_string(t_doc));
 #endif
 
-    scope.insert({ name, new_fun });
+    scope.insert({ t_sym->symbol_id(), new_fun });
 }
 
 }  // namespace alisp
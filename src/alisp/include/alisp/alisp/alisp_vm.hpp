@@ -0,0 +1,148 @@
+/*   Alisp - the alisp interpreted language
+     Copyright (C) 2020 Stanislav Arnaudov
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any prior version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along
+ with this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "alisp/alisp/alisp_common.hpp"
+#include "alisp/alisp/alisp_env.hpp"
+#include "alisp/alisp/alisp_eval.hpp"
+
+#if defined(__GNUC__) || defined(__clang__)
+#define ALISP_VM_COMPUTED_GOTO
+#endif
+
+namespace alisp
+{
+
+namespace vm
+{
+
+/*
+ * The bytecode engine lowers (already optimized) forms into flat chunks of
+ * instructions. The control flow constructs of the language are compiled
+ * directly, calls to primitives are dispatched with the argument list
+ * prepared at compile time and everything else falls back to the tree
+ * walking evaluator.
+ */
+
+enum class OpCode : std::uint8_t
+{
+    PUSH_CONST,
+    LOAD_SYM,
+    SET_SYM,
+    POP,
+    JUMP,
+    JUMP_IF_NIL,
+    JUMP_IF_NOT_NIL,
+    CALL_PRIME,
+    LOAD_FUNC,
+    CALL,
+    EVAL,
+    WHILE,
+    DOLIST,
+    RETURN
+};
+
+struct Instruction
+{
+    OpCode op;
+    std::uint32_t arg;
+};
+
+struct Chunk;
+
+struct CallSite
+{
+    ALObjectPtr form;
+    ALObjectPtr callee;
+    ALObjectPtr args;
+    std::uint32_t argc;
+    std::uint32_t end;
+};
+
+struct Loop
+{
+    ALObjectPtr form;
+    ALObjectPtr symbol;
+    std::unique_ptr<Chunk> head;
+    std::unique_ptr<Chunk> body;
+};
+
+struct Chunk
+{
+    std::vector<Instruction> code;
+    std::vector<ALObjectPtr> constants;
+    std::vector<CallSite> calls;
+    std::vector<Loop> loops;
+};
+
+std::unique_ptr<Chunk> compile(const ALObjectPtr &t_obj);
+
+std::unique_ptr<Chunk> compile_body(const ALObjectPtr &t_body, size_t t_offset = 0);
+
+std::string disassemble(const Chunk &t_chunk);
+
+
+class VirtualMachine
+{
+  private:
+    struct CachedChunk
+    {
+#ifdef USE_MANUAL_MEMORY
+        ALObject *body;
+#else
+        std::weak_ptr<ALObject> body;
+#endif
+        std::unique_ptr<Chunk> chunk;
+    };
+
+    env::Environment &m_env;
+    eval::Evaluator &m_eval;
+
+    std::vector<ALObjectPtr> m_stack;
+    std::unordered_map<const ALObject *, CachedChunk> m_bodies;
+    size_t m_sweep_threshold;
+
+    ALObjectPtr run_loop(const Loop &t_loop, OpCode t_op);
+
+    void sweep();
+
+  public:
+    VirtualMachine(env::Environment &t_env, eval::Evaluator &t_eval);
+
+    ~VirtualMachine();
+
+    ALISP_RAII_OBJECT(VirtualMachine);
+
+    ALObjectPtr run(const Chunk &t_chunk);
+
+    ALObjectPtr eval(const ALObjectPtr &t_obj);
+
+    ALObjectPtr eval_body(const ALObjectPtr &t_body);
+
+    size_t cached_bodies() const { return m_bodies.size(); }
+};
+
+}  // namespace vm
+
+}  // namespace alisp
@@ -126,6 +126,8 @@ class AsyncS
   public:
     AsyncS(eval::Evaluator *t_eval, bool defer_init = false);
 
+    ~AsyncS();
+
     void spin_loop();
 
 
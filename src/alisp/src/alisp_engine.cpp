@@ -17,6 +17,7 @@
 
 
 #include "alisp/alisp/alisp_engine.hpp"
+#include "alisp/alisp/alisp_gc.hpp"
 
 
 namespace alisp
@@ -29,34 +30,61 @@ LanguageEngine::LanguageEngine(std::vector<EngineSettings> t_setting,
   : m_environment()
   , m_parser(std::make_unique<parser::ALParser<env::Environment>>(m_environment))
   , m_evaluator(m_environment, m_parser.get(), utility::env_bool(ENV_VAR_DEFER_EL))
+  , m_vm(m_environment, m_evaluator)
+  , g_optimizer(m_evaluator)
   , m_settings(std::move(t_setting))
   , m_argv(std::move(t_cla))
   , m_imports(std::move(t_extra_imports))
   , m_warnings(std::move(t_warnings))
   , m_home_directory(utility::env_string("HOME"))
 {
+    if (check(EngineSettings::BYTECODE) or utility::env_bool(ENV_VAR_BYTECODE))
+    {
+        m_evaluator.set_vm(&m_vm);
+    }
+
     init_system();
 }
 
-void LanguageEngine::do_eval(std::string &t_input, const std::string &t_file, bool t_print_res)
+optimizer::Level LanguageEngine::optimization_level()
 {
-
-    auto parse_result = m_parser->parse(t_input, t_file);
+    if (check(EngineSettings::FULL_OPTIMIZATION) or utility::env_string(ENV_VAR_OPTIMIZE) == "2")
+    {
+        return optimizer::Level::ALGEBRAIC;
+    }
 
     if (check(EngineSettings::OPTIMIZATION) or utility::env_bool(ENV_VAR_OPTIMIZE))
     {
-        g_optimizer.optimize(parse_result);
+        return optimizer::Level::FOLDING;
     }
 
+    return optimizer::Level::NONE;
+}
+
+void LanguageEngine::do_eval(std::string &t_input, const std::string &t_file, bool t_print_res)
+{
+
+    auto parse_result = m_parser->parse(t_input, t_file);
+
+    g_optimizer.optimize(parse_result, optimization_level());
+
     for (auto sexp : parse_result)
     {
         if (check(EngineSettings::PARSER_DEBUG)) std::cout << "DEUBG[PARSER]: " << alisp::dump(sexp) << "\n";
-        auto eval_result = m_evaluator.eval(sexp);
+        auto eval_result = m_evaluator.vm() != nullptr ? m_vm.eval(sexp) : m_evaluator.eval(sexp);
         if (check(EngineSettings::EVAL_DEBUG)) std::cout << "DEUBG[EVAL]: " << alisp::dump(eval_result) << "\n";
         if (t_print_res)
         {
             std::cout << *eval_result << "\n";
         }
+
+#ifdef USE_GC_MEMORY
+        if (m_evaluator.evaluation_depth() == 0 and !m_evaluator.is_async_pending())
+        {
+            gc::Roots roots{ parse_result };
+            gc::heap().safepoint();
+        }
+#endif
     }
 }
 
@@ -122,6 +150,10 @@ void LanguageEngine::init_system()
     Vdebug_mode = check(EngineSettings::DISABLE_DEBUG_MODE) or utility::env_bool(ENV_VAR_NODEBUG) ? Qnil : Qt;
 
     set_executable(utility::System::executable());
+
+#ifdef USE_GC_MEMORY
+    gc::heap().seal();
+#endif
 }
 
 std::pair<bool, int> LanguageEngine::handle_exceptions() const noexcept
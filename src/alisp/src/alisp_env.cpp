@@ -17,13 +17,16 @@
 
 
 #include <algorithm>
+#include <unordered_set>
 
 #include "alisp/alisp/alisp_common.hpp"
 #include "alisp/alisp/alisp_env.hpp"
+#include "alisp/alisp/alisp_resolver.hpp"
 #include "alisp/alisp/alisp_eval.hpp"
 #include "alisp/alisp/alisp_object.hpp"
 #include "alisp/alisp/alisp_exception.hpp"
 #include "alisp/alisp/alisp_exception.hpp"
+#include "alisp/alisp/alisp_gc.hpp"
 #include "alisp/alisp/declarations/constants.hpp"
 
 #include "alisp/utility/macros.hpp"
@@ -41,90 +44,185 @@ namespace env
 Environment::Environment()
   : m_modules{ { "--main--", std::make_shared<Module>("--main--") } }
   , m_active_module({ *m_modules.at("--main--").get() })
+  , m_main_module({ *m_modules.at("--main--").get() })
   , m_call_depth(0)
 {
+    invalidate_call_sites();
+
+#ifdef USE_GC_MEMORY
+    gc::heap().add_roots(
+      this,
+      [this](gc::Marker &t_marker) {
+          for (auto &cell : m_stack.cells)
+          {
+              t_marker.mark(cell.symbol);
+              t_marker.mark(cell.value);
+          }
+          t_marker.mark_values(g_user_symbols);
+          t_marker.mark_values(g_internal_symbols);
+          t_marker.mark_values(g_prime_values);
+
+          std::unordered_set<Module *> visited;
+          std::vector<Module *> pending;
+          for (auto &[_, mod] : m_modules)
+          {
+              pending.push_back(mod.get());
+          }
+
+          while (!pending.empty())
+          {
+              auto mod = pending.back();
+              pending.pop_back();
+              if (!visited.insert(mod).second)
+              {
+                  continue;
+              }
+
+              t_marker.mark_values(mod->root_scope());
+              for (auto obj : mod->eval_objs())
+              {
+                  t_marker.mark(obj);
+              }
+              for (auto &[_, sub] : mod->modules())
+              {
+                  pending.push_back(sub.get());
+              }
+          }
+      });
+#endif
 }
 
 Environment::~Environment()
 {
+#ifdef USE_GC_MEMORY
+    gc::heap().remove_roots(this);
+#endif
     g_user_symbols.clear();
 }
 
 ALObjectPtr Environment::find(const ALObjectPtr &t_sym)
 {
+    AL_DEBUG("Finding a symbol: "s += t_sym->to_string());
 
-    const auto name = t_sym->to_string();
+    if (auto cell = m_stack.find(t_sym); cell != nullptr)
+    {
+        return *cell;
+    }
 
-    AL_DEBUG("Finding a symbol: "s += name);
+    auto &value = *global_cell(t_sym).cell;
 
-    for (auto &scope : utility::reverse(m_stack.current_frame()))
+    // switching modules does not touch the variable holding the name of the
+    // active one, it is brought up to date when it is read
+    if (ALISP_UNLIKELY(value == Vcurrent_module))
     {
-        if (scope.count(name))
-        {
-            return scope.at(name);
-        };
+        Vcurrent_module->set(current_module());
     }
 
-    if (g_prime_values.count(name))
+    return value;
+}
+
+Module::GlobalCell &Environment::global_cell(const ALObjectPtr &t_sym)
+{
+    auto &module = m_active_module.get();
+    auto &cache  = module.global_cache();
+
+    // nothing is ever removed from the root scopes, so their combined size
+    // changes whenever a definition could shadow a cached cell
+    const auto generation =
+      std::size(g_prime_values) + std::size(module.root_scope()) + std::size(m_main_module.get().root_scope());
+
+    const auto id = t_sym->symbol_id();
+
+    if (auto it = cache.find(id); it != std::end(cache) and it->second.generation == generation)
     {
-        return g_prime_values.at(name);
+        return it->second;
     }
 
-    if (m_active_module.get().root_scope().count(name))
-    {
-        return m_active_module.get().root_scope().at(name);
+    auto lookup = [&]() -> std::pair<ALObjectPtr *, bool> {
+        if (auto it = g_prime_values.find(id); it != std::end(g_prime_values))
+        {
+            return { &it->second, false };
+        }
+
+        if (auto it = module.root_scope().find(id); it != std::end(module.root_scope()))
+        {
+            return { &it->second, true };
+        }
+
+        auto &main_root = m_main_module.get().root_scope();
+        if (auto it = main_root.find(id); it != std::end(main_root))
+        {
+            return { &it->second, false };
+        }
+
+        throw environment_error("Unbounded Symbol: " + t_sym->to_string());
     };
 
-    if (m_modules.at("--main--")->root_scope().count(name))
+    const auto [cell, in_root] = lookup();
+
+    if (std::size(cache) >= Module::GLOBAL_CACHE_SIZE)
     {
-        return m_modules.at("--main--")->root_scope().at(name);
-    };
+        cache.clear();
+    }
 
-    throw environment_error("Unbounded Symbol: " + name);
+    auto &entry = cache[id];
+    entry       = { cell, generation, in_root };
+    return entry;
 }
 
 void Environment::update(const ALObjectPtr &t_sym, ALObjectPtr t_value)
 {
-    const auto name = t_sym->to_string();
+    auto cell = m_stack.find(t_sym);
 
-    for (auto &scope : m_stack.current_frame())
+    if (cell == nullptr)
     {
-        if (scope.count(name))
+        auto &global = global_cell(t_sym);
+        if (!global.in_root)
         {
-            auto &sym = scope.at(name);
-            AL_CHECK(
-              if (sym->check_const_flag()) { throw environment_error("Trying to change a const symbol: " + name); });
-            sym = std::move(t_value);
-            return;
-        };
-    }
+            throw environment_error("Unbounded Symbol: " + t_sym->to_string());
+        }
+        cell = global.cell;
 
-    if (m_active_module.get().root_scope().count(name))
-    {
-        auto &sym = m_active_module.get().root_scope().at(name);
-        AL_CHECK(if (sym->check_const_flag()) { throw environment_error("Trying to change a const symbol: " + name); });
-        sym = std::move(t_value);
-        return;
-    };
+        // the call sites cache the cell itself, only the kind of the callee can go stale
+        if ((*cell)->check_function_flag() or t_value->check_function_flag())
+        {
+            invalidate_call_sites();
+        }
+    }
 
-    throw environment_error("Unbounded Symbol: " + name);
+    AL_CHECK(if ((*cell)->check_const_flag()) {
+        throw environment_error("Trying to change a const symbol: " + t_sym->to_string());
+    });
+    *cell = std::move(t_value);
 }
 
 void Environment::put(const ALObjectPtr &t_sym, ALObjectPtr t_val)
 {
-    auto &scope = m_stack.current_scope();
-    auto name   = t_sym->to_string();
-
     // NameValidator::validate_object_name(name);
 
-    if (scope.count(name))
+    if (!m_stack.put(t_sym, std::move(t_val)))
     {
-        scope.at(name) = t_val;
-        warn::warn_env("Putting an already existent variable in the env: "s += name);
+        warn::warn_env("Putting an already existent variable in the env: "s += t_sym->to_string());
         // throw environment_error("Variable alredy exists: " + name);
     }
+}
 
-    scope.insert({ name, std::move(t_val) });
+void Environment::bind(const ALObjectPtr &t_sym, ALObjectPtr t_val)
+{
+    if (!m_stack.bind(t_sym, std::move(t_val)))
+    {
+        warn::warn_env("Putting an already existent variable in the env: "s += t_sym->to_string());
+    }
+}
+
+void Environment::unload_closure(const ALObjectPtr &t_closure)
+{
+    const auto len = t_closure->length();
+    for (size_t i = 0; i + 1 < len; i += 2)
+    {
+        m_stack.bind(t_closure->i(i), t_closure->i(i + 1));
+    }
+    m_stack.seal_closure();
 }
 
 void Environment::define_variable(const ALObjectPtr &t_sym, ALObjectPtr t_value, std::string t_doc, bool t_const)
@@ -136,12 +234,13 @@ void Environment::define_variable(const ALObjectPtr &t_sym, ALObjectPtr t_value,
 
     NameValidator::validate_object_name(name);
 
-    AL_CHECK(if (scope.count(name)) { throw environment_error("Variable alredy exists: " + name); });
-    t_value->set_prop("--name--", make_string(name));
-    t_value->set_prop("--module--", make_string(m_active_module.get().name()));
+    AL_CHECK(if (scope.count(t_sym->symbol_id())) { throw environment_error("Variable alredy exists: " + name); });
+    t_value = make_mutable(std::move(t_value));
+    t_value->set_prop(PropKey::NAME, make_string(name));
+    t_value->set_prop(PropKey::MODULE, make_string(m_active_module.get().name()));
 
 #ifdef ENABLE_OBJECT_DOC
-    t_value->set_prop("--doc--", make_string(t_doc));
+    t_value->set_prop(PropKey::DOC, make_string(t_doc));
 #endif
 
     if (t_const)
@@ -149,7 +248,8 @@ void Environment::define_variable(const ALObjectPtr &t_sym, ALObjectPtr t_value,
         t_value->set_const_flag();
     }
 
-    scope.insert({ name, std::move(t_value) });
+    scope.insert({ t_sym->symbol_id(), std::move(t_value) });
+    invalidate_call_sites();
 }
 
 void Environment::define_function(const ALObjectPtr &t_sym, ALObjectPtr t_params, ALObjectPtr t_body, std::string t_doc)
@@ -162,18 +262,22 @@ void Environment::define_function(const ALObjectPtr &t_sym, ALObjectPtr t_params
 
     NameValidator::validate_object_name(name);
 
-    AL_CHECK(if (scope.count(name)) { throw environment_error("Function alredy exists: " + name); });
+    AL_CHECK(if (scope.count(t_sym->symbol_id())) { throw environment_error("Function alredy exists: " + name); });
+
+    resolve_function(*this, t_params, t_body, name);
 
     auto new_fun = make_object(t_params, t_body);
     new_fun->set_function_flag();
-    new_fun->set_prop("--module--", make_string(m_active_module.get().name()));
-    new_fun->set_prop("--name--", make_string(name));
+    new_fun->set_prop(PropKey::MODULE, make_string(m_active_module.get().name()));
+    new_fun->set_module(&m_active_module.get());
+    new_fun->set_prop(PropKey::NAME, make_string(name));
 
 #ifdef ENABLE_OBJECT_DOC
-    new_fun->set_prop("--doc--", make_string(t_doc));
+    new_fun->set_prop(PropKey::DOC, make_string(t_doc));
 #endif
 
-    scope.insert({ name, std::move(new_fun) });
+    scope.insert({ t_sym->symbol_id(), std::move(new_fun) });
+    invalidate_call_sites();
 }
 
 void Environment::define_macro(const ALObjectPtr &t_sym, ALObjectPtr t_params, ALObjectPtr t_body, std::string t_doc)
@@ -186,24 +290,25 @@ void Environment::define_macro(const ALObjectPtr &t_sym, ALObjectPtr t_params, A
 
     NameValidator::validate_object_name(name);
 
-    AL_CHECK(if (scope.count(name)) { throw environment_error("Function alredy exists: " + name); });
+    AL_CHECK(if (scope.count(t_sym->symbol_id())) { throw environment_error("Function alredy exists: " + name); });
 
     auto new_fun = make_object(t_params, t_body);
     new_fun->set_function_flag();
     new_fun->set_macro_flag();
-    new_fun->set_prop("--module--", make_string(m_active_module.get().name()));
-    new_fun->set_prop("--name--", make_string(name));
+    new_fun->set_prop(PropKey::MODULE, make_string(m_active_module.get().name()));
+    new_fun->set_module(&m_active_module.get());
+    new_fun->set_prop(PropKey::NAME, make_string(name));
 
 #ifdef ENABLE_OBJECT_DOC
-    new_fun->set_prop("--doc--", make_string(t_doc));
+    new_fun->set_prop(PropKey::DOC, make_string(t_doc));
 #endif
 
-    scope.insert({ name, std::move(new_fun) });
+    scope.insert({ t_sym->symbol_id(), std::move(new_fun) });
+    invalidate_call_sites();
 }
 
 void Environment::activate_module(const std::string &t_name)
 {
-    Vcurrent_module->set(t_name);
     m_active_module = *m_modules.at(t_name).get();
 }
 
@@ -266,18 +371,19 @@ void Environment::import_root_scope(const std::string &t_from, const std::string
         warn::warn_import("Importing an empty root scope.");
     }
 
-    for (auto &[name, sym] : from_root)
+    for (auto &[id, sym] : from_root)
     {
-        AL_DEBUG("Adding a symbol: "s += name);
-        if (!sym->prop_exists("--module--"))
+        AL_DEBUG("Adding a symbol: "s += symbol_name(id));
+        if (!sym->prop_exists(PropKey::MODULE))
         {
             continue;
         }
-        if (sym->get_prop("--module--")->to_string().compare(t_from) == 0)
+        if (sym->get_prop(PropKey::MODULE)->to_string().compare(t_from) == 0)
         {
-            to_root.insert({ name, sym });
+            to_root.insert({ id, sym });
         }
     }
+    invalidate_call_sites();
 
     // m_modules.at(t_to)->get_root() = m_modules.at(t_from)->get_root();
 }
@@ -307,11 +413,11 @@ void Environment::alias_module(const std::string &t_name, const std::string &t_a
 void Environment::defer_callback(std::function<void()> t_callback)
 {
 
-    if (m_stack.current_frame().size() == 1)
+    if (m_stack.frame_scopes() == 1)
     {
         return;
     }
-    m_deferred_calls.emplace_back(m_stack.stacks.size(), m_stack.current_frame().size(), t_callback);
+    m_deferred_calls.emplace_back(m_stack.frames.size(), m_stack.frame_scopes(), t_callback);
 }
 
 void Environment::define_module(const std::string t_name, const std::string)
@@ -335,8 +441,8 @@ bool Environment::module_loaded(const std::string &t_module_name)
 void Environment::resolve_callbacks()
 {
     while (!m_deferred_calls.empty()
-           and (m_stack.current_frame().size() <= std::get<0>(m_deferred_calls.back())
-                and m_stack.stacks.size() <= std::get<1>(m_deferred_calls.back())))
+           and (m_stack.frame_scopes() <= std::get<0>(m_deferred_calls.back())
+                and m_stack.frames.size() <= std::get<1>(m_deferred_calls.back())))
     {
         std::invoke(std::get<2>(m_deferred_calls.back()));
         m_deferred_calls.pop_back();
@@ -352,21 +458,23 @@ void Environment::stack_dump() const
 
     cout << format("+{:-^48}+", "Stack") << '\n';
 
-    size_t frame_index    = 0;
-    const auto stack_size = std::size(m_stack.stacks);
+    const auto stack_size = std::size(m_stack.frames);
 
-    for (auto &frame : m_stack.stacks)
+    for (size_t frame_index = 0; frame_index < stack_size; ++frame_index)
     {
+        const auto first_scope = m_stack.frames[frame_index].scopes;
+        const auto last_scope =
+          frame_index + 1 < stack_size ? m_stack.frames[frame_index + 1].scopes : std::size(m_stack.scopes);
+
         cout << format("|{:^48}|", format("Frame {}", frame_index)) << '\n';
         cout << format("|{:^48}|", "") << '\n';
 
         cout << format("+{:-^10}+", "");
         cout << format("{:-^37}+", "") << '\n';
 
-        size_t scope_index = 0;
-
-        for (auto &scope : frame)
+        for (auto scope = first_scope; scope < last_scope; ++scope)
         {
+            const auto scope_index = scope - first_scope;
 
             if (scope_index != 0)
             {
@@ -380,14 +488,15 @@ void Environment::stack_dump() const
             cout << format("+{:-^10}+", "");
             cout << format("{:-^37}+", "") << '\n';
 
-            for (auto &[sym, val] : scope)
+            const auto last_cell = scope + 1 < std::size(m_stack.scopes) ? m_stack.scopes[scope + 1]
+                                                                          : std::size(m_stack.cells);
+
+            for (auto cell = m_stack.scopes[scope]; cell < last_cell; ++cell)
             {
                 cout << format("|{:<10}|", "");
 
-                std::cout << format("{:<37}|", sym) << '\n';
+                std::cout << format("{:<37}|", m_stack.cells[cell].symbol->to_string()) << '\n';
             }
-
-            ++scope_index;
         }
 
         if (frame_index != stack_size - 1)
@@ -395,8 +504,6 @@ void Environment::stack_dump() const
             cout << format("+{:-^10}+", "");
             cout << format("{:-^37}+", "") << '\n';
         }
-
-        ++frame_index;
     }
 
 
@@ -421,7 +528,7 @@ void Environment::env_dump() const
     size_t index = 1;
     for (auto &[sym, _] : g_prime_values)
     {
-        cout << format("|{:<5}{:^43}|", index++, sym) << '\n';
+        cout << format("|{:<5}{:^43}|", index++, symbol_name(sym)) << '\n';
     }
 
 
@@ -434,13 +541,43 @@ void Environment::env_dump() const
         index = 1;
         for (auto &[sym, _] : mod->get_root())
         {
-            cout << format("|{:<5}{:^43}|", index++, sym) << '\n';
+            cout << format("|{:<5}{:^43}|", index++, symbol_name(sym)) << '\n';
         }
     }
 
     cout << format("+{:-^48}+", "") << '\n';
 }
 
+#ifdef ENABLE_STACK_TRACE
+
+std::vector<Environment::CallElement> Environment::call_stack() const
+{
+    std::vector<CallElement> calls;
+    calls.reserve(std::size(m_call_frames));
+
+    for (auto &frame : m_call_frames)
+    {
+        auto &call = calls.emplace_back();
+
+        call.m_function = frame.m_callee->prop_exists(PropKey::NAME)
+                            ? frame.m_callee->get_prop(PropKey::NAME)->to_string()
+                            : "anonymous";
+        call.m_is_prime = frame.m_callee->check_prime_flag();
+
+        if (frame.m_form->check_located_flag())
+        {
+            if (const auto location = SourceMap::find(frame.m_form); location != nullptr)
+            {
+                call.m_location = *location;
+            }
+        }
+    }
+
+    return calls;
+}
+
+#endif
+
 void Environment::callstack_dump() const
 {
 
@@ -451,17 +588,20 @@ void Environment::callstack_dump() const
     cout.flush();
     cout << format("+{:-^48}+", "Call stack") << '\n';
 
-    for (auto &call : utility::reverse(m_stack_trace))
+    const auto calls = call_stack();
+    for (auto &call : utility::reverse(calls))
     {
+        const auto file = call.m_location ? SourceMap::file_name(call.m_location->file) : std::string{};
+        const auto line = call.m_location ? call.m_location->line : 0u;
 
         if (call.m_is_prime)
         {
             cout << '(' << rang::fg::cyan << call.m_function << rang::fg::reset << ')';
-            cout << format("\n\t{}:{}\n", call.m_file, call.m_line);
+            cout << format("\n\t{}:{}\n", file, line);
         }
         else
         {
-            cout << format("({})\n\t{}:{}\n", call.m_function, call.m_file, call.m_line);
+            cout << format("({})\n\t{}:{}\n", call.m_function, file, line);
         }
     }
 
@@ -478,21 +618,29 @@ FunctionCall::FunctionCall(Environment &t_env, ALObjectPtr t_func, ALObjectPtr)
     m_env.call_function();
 
     // unload the closure here
-    if (t_func->prop_exists("--closure--"))
+    if (t_func->prop_exists(PropKey::CLOSURE))
+    {
+        t_env.unload_closure(t_func->get_prop(PropKey::CLOSURE));
+    }
+
+    if (auto func_module = t_func->module(); ALISP_LIKELY(func_module != nullptr))
     {
-        for (auto &el : *(t_func->get_prop("--closure--")))
+        if (func_module != &m_env.current_module_ref())
         {
-            t_env.put(el->i(0), el->i(1));
+            m_prev_mod = &m_env.current_module_ref();
+            m_env.activate_module(*func_module);
         }
+
+        return;
     }
 
-    if (ALISP_LIKELY(t_func->prop_exists("--module--")))
+    if (t_func->prop_exists(PropKey::MODULE))
     {
-        auto func_module = t_func->get_prop("--module--")->to_string();
+        auto func_module = t_func->get_prop(PropKey::MODULE)->to_string();
         if (m_env.current_module().compare(func_module) != 0)
         {
-            m_prev_mod = m_env.current_module();
-            t_env.activate_module(func_module);
+            m_prev_mod = &m_env.current_module_ref();
+            m_env.activate_module(func_module);
         }
 
         return;
@@ -503,9 +651,9 @@ FunctionCall::FunctionCall(Environment &t_env, ALObjectPtr t_func, ALObjectPtr)
 
 FunctionCall::~FunctionCall()
 {
-    if (!m_prev_mod.empty())
+    if (m_prev_mod != nullptr)
     {
-        m_env.activate_module(m_prev_mod);
+        m_env.activate_module(*m_prev_mod);
     }
     m_env.finish_function();
 }
@@ -532,7 +680,7 @@ MacroCall::~MacroCall()
 }
 
 ModuleChange::ModuleChange(Environment &t_env, const std::string &t_module)
-  : m_env(t_env), m_prev_mod(m_env.current_module())
+  : m_env(t_env), m_prev_mod(m_env.current_module_ref())
 {
 
     m_env.activate_module(t_module);
@@ -23,10 +23,13 @@
 #include "alisp/alisp/alisp_factory.hpp"
 #include "alisp/alisp/alisp_assertions.hpp"
 #include "alisp/alisp/alisp_signature.hpp"
+#include "alisp/alisp/alisp_vm.hpp"
 
 #include "alisp/utility.hpp"
 
 #include <algorithm>
+#include <optional>
+#include <utility>
 
 namespace alisp
 {
@@ -50,10 +53,17 @@ void Evaluator::end_evaluation()
 }
 
 Evaluator::Evaluator(env::Environment &env_, parser::ParserBase *t_parser, bool t_defer_el)
-  : env(env_), m_eval_depth(0), m_catching_depth(0), m_parser(t_parser), m_async(this, t_defer_el), m_status_flags(0)
+  : env(env_)
+  , m_eval_depth(0)
+  , m_catching_depth(0)
+  , m_parser(t_parser)
+  , m_vm(nullptr)
+  , m_async(this, t_defer_el)
+  , m_status_flags(0)
 {
 
     m_lock = std::unique_lock<std::mutex>(callback_m, std::defer_lock);
+    m_value_stack.reserve(VALUE_STACK_SIZE);
 }
 
 Evaluator::~Evaluator()
@@ -68,6 +78,13 @@ void Evaluator::put_argument(const ALObjectPtr &param, ALObjectPtr arg)
     this->env.put(param, arg);
 }
 
+void Evaluator::bind_argument(const ALObjectPtr &param, ALObjectPtr arg)
+{
+    AL_DEBUG("Binding argument: "s += dump(param) + " -> " + dump(arg));
+
+    this->env.bind(param, arg);
+}
+
 void Evaluator::handle_argument_bindings(const ALObjectPtr &params,
                                          ALObjectPtr eval_args,
                                          std::function<void(ALObjectPtr, ALObjectPtr)> handler)
@@ -146,6 +163,42 @@ void Evaluator::handle_argument_bindings(const ALObjectPtr &params,
     AL_CHECK(if (index < arg_cnt) { throw argument_error("Too many arguments provided for the function call."); });
 }
 
+namespace
+{
+
+CallSiteCache describe_callee(const ALObjectPtr &t_func)
+{
+    CallSiteCache site;
+    if (t_func->check_prime_flag())
+    {
+        site.kind    = CallSiteCache::Kind::PRIME;
+        site.managed = t_func->prop_exists(PropKey::MANAGED);
+        site.bounds  = t_func->arg_bounds();
+    }
+    else if (t_func->check_macro_flag())
+    {
+        site.kind = CallSiteCache::Kind::MACRO;
+    }
+    return site;
+}
+
+void check_argument_count(const ArgBounds &t_bounds, size_t t_count)
+{
+    AL_CHECK(if (t_bounds.empty and t_count != 0) { throw argument_error("Argument\'s lengths do not match."); });
+
+    if (t_count < t_bounds.min)
+    {
+        throw argument_error("The function requires more arguments than the provided ones.");
+    }
+
+    AL_CHECK(if (!t_bounds.well_formed) { throw argument_error("The argument list ends with &optional or &rest."); });
+    AL_CHECK(if (t_count > t_bounds.max) {
+        throw argument_error("Too many arguments provided for the function call.");
+    });
+}
+
+}  // namespace
+
 ALObjectPtr Evaluator::eval(const ALObjectPtr &obj)
 {
     detail::EvalDepthTrack track{ *this };
@@ -173,20 +226,29 @@ ALObjectPtr Evaluator::eval(const ALObjectPtr &obj)
 
         case ALObjectType::LIST: {
 
-            auto func = [this, &obj]() {
-                if (pprime(obj))
-                {
-                    return obj;
-                }
-                else
-                {
-                    return eval(obj->i(0));
-                }
-            }();
+            // the arguments are a view into the form that lives as long as the call
+            ALObject args_view{ std::next(std::begin(*obj)), std::end(*obj) };
+            const auto args = ::alisp::detail::ALObjectHelper::init_ptr_borrowed(&args_view);
+
+            if (pprime(obj))
+            {
+                return eval_callable(obj, args, obj);
+            }
 
             AL_DEBUG("Calling funcion: "s += dump(obj->i(0)));
 
-            return eval_callable(func, splice(obj, 1), obj);
+            const auto &head = obj->i(0);
+            if (psym(head) and head->to_string().front() != ':' and env.stack().find(head) == nullptr)
+            {
+                const auto site = call_site(obj, head);
+                if (site.expansion != nullptr)
+                {
+                    return eval_tail(site.expansion);
+                }
+                return dispatch(*site.cell, site, args, obj, false);
+            }
+
+            return eval_callable(eval(head), args, obj);
         }
 
         default: {
@@ -197,7 +259,10 @@ ALObjectPtr Evaluator::eval(const ALObjectPtr &obj)
     return nullptr;
 }
 
-ALObjectPtr Evaluator::eval_callable(const ALObjectPtr &callable, const ALObjectPtr &args, const ALObjectPtr &obj)
+ALObjectPtr Evaluator::eval_callable(const ALObjectPtr &callable,
+                                     const ALObjectPtr &args,
+                                     const ALObjectPtr &obj,
+                                     bool evaluated_args)
 {
     auto func = callable;
     if (psym(func))
@@ -207,76 +272,111 @@ ALObjectPtr Evaluator::eval_callable(const ALObjectPtr &callable, const ALObject
 
     AL_CHECK(if (!func->check_function_flag()) { throw eval_error("Head of a list must be bound to function"); });
 
+    return dispatch(func, describe_callee(func), args, obj, evaluated_args);
+}
 
-#ifdef ENABLE_STACK_TRACE
-    env::detail::CallTracer tracer{ env };
-    if (obj->prop_exists("--line--"))
-    {
-        tracer.line(obj->get_prop("--line--")->to_int());
-        tracer.file(obj->get_prop("--file--")->to_string());
-    }
-    if (func->prop_exists("--name--"))
-    {
-        tracer.function_name(func->get_prop("--name--")->to_string(), func->check_prime_flag());
-    }
-    else
+CallSiteCache Evaluator::call_site(const ALObjectPtr &obj, const ALObjectPtr &head)
+{
+    const void *module = &env.current_module_ref();
+    auto &site         = obj->call_site();
+
+    if (site.epoch != env::Environment::g_call_epoch or site.module != module)
     {
-        tracer.function_name("anonymous", false);
+        auto cell = env.global_cell(head).cell;
+
+        AL_CHECK(if (!(*cell)->check_function_flag()) {
+            throw eval_error("Head of a list must be bound to function");
+        });
+
+        site        = describe_callee(*cell);
+        site.epoch  = env::Environment::g_call_epoch;
+        site.module = module;
+        site.cell   = cell;
     }
-    tracer.catch_depth(m_catching_depth);
+
+    return site;
+}
+
+ALObjectPtr Evaluator::dispatch(const ALObjectPtr &callee,
+                                const CallSiteCache &site,
+                                const ALObjectPtr &args,
+                                const ALObjectPtr &obj,
+                                bool evaluated_args)
+{
+    // the callee may be a cell of the environment that is rebound during the call
+    const ALObjectPtr func = callee;
+
+#ifdef ENABLE_STACK_TRACE
+    env::detail::CallTracer tracer{ env, getraw(func), getraw(obj) };
 #endif
 
 
+    // a prime called through funcall, mapc & co. is not evaluated as
+    // a statement even when the calling form is
+    std::optional<detail::FlowScope> barrier;
+    if (is_falsy(obj))
+    {
+        barrier.emplace(*this, detail::FlowScope::Kind::BARRIER);
+    }
+
     try
     {
 
-        if (func->check_prime_flag())
+        if (site.kind == CallSiteCache::Kind::PRIME)
         {
-            return apply_prime(func, args, obj);
+            return apply_prime(func, args, site);
         }
-        else if (func->check_macro_flag())
+        else if (site.kind == CallSiteCache::Kind::MACRO)
         {
-            env::detail::MacroCall fc{ env };
-            auto expanded = apply_macro(func, args);
+            auto expanded = [&] {
+                env::detail::MacroCall fc{ env };
+                return apply_macro(func, args);
+            }();
+            if (is_unwinding())
+            {
+                return m_unwind_value;
+            }
             AL_DEBUG("Macro expansion: "s += dump(expanded));
-            return eval(expanded);
+
+            // a form whose macro is resolved through the call site cache is
+            // expanded once; redefining the macro invalidates the expansion
+            if (site.cell != nullptr)
+            {
+                obj->call_site().expansion = expanded;
+            }
+            return eval_tail(expanded);
         }
         else
         {
 
-            auto eval_args = [&]() {
-                if (is_truthy(obj))
-                {
-                    return eval_transform(this, args);
-                }
-                else
-                {
-                    return args;
-                }
-            }();
+            if (is_falsy(obj) or evaluated_args)
+            {
+                return call_function(func, args);
+            }
 
-            env::detail::FunctionCall fc{ env, func };
-            return apply_function(func, eval_args);
+            ArgumentWindow eval_args{ *this, args };
+            if (m_tail_chain == m_eval_depth and m_vm == nullptr)
+            {
+                m_tail_callee = func;
+                m_tail_args.assign(std::begin(*eval_args.values()), std::end(*eval_args.values()));
+                return Qnil;
+            }
+
+            return call_function(func, eval_args.values());
         }
     }
-    catch (al_continue &)
-    {
-        throw;
-    }
-    catch (al_break &)
-    {
-        throw;
-    }
-    catch (al_exit &)
-    {
-        throw;
-    }
-    catch (al_return &)
+    catch (interrupt_error &)
     {
         throw;
     }
-    catch (interrupt_error &)
+    catch (al_exception &exc)
     {
+#ifdef ENABLE_STACK_TRACE
+        if (m_catching_depth == 0 and exc.tag() != SignalTag::FLOW_CONTROL)
+        {
+            tracer.dump();
+        }
+#endif
         throw;
     }
     catch (...)
@@ -293,6 +393,42 @@ ALObjectPtr Evaluator::eval_callable(const ALObjectPtr &callable, const ALObject
     }
 }
 
+ALObjectPtr Evaluator::eval_statement(const ALObjectPtr &obj)
+{
+    detail::FlowScope scope{ *this, detail::FlowScope::Kind::STATEMENT };
+    return eval(obj);
+}
+
+ALObjectPtr Evaluator::eval_tail(const ALObjectPtr &obj)
+{
+    detail::FlowScope scope{ *this, detail::FlowScope::Kind::TAIL };
+    return eval_statement(obj);
+}
+
+bool Evaluator::start_unwind(Unwind t_kind, ALObjectPtr t_value)
+{
+    const auto chain = t_kind == Unwind::RETURN ? m_return_chain : m_loop_chain;
+    if (chain != m_eval_depth)
+    {
+        return false;
+    }
+
+    m_unwind       = t_kind;
+    m_unwind_value = std::move(t_value);
+    return true;
+}
+
+Unwind Evaluator::consume_loop_unwind()
+{
+    const auto kind = m_unwind;
+    if (kind == Unwind::BREAK or kind == Unwind::CONTINUE)
+    {
+        m_unwind       = Unwind::NONE;
+        m_unwind_value = nullptr;
+    }
+    return kind;
+}
+
 ALObjectPtr Evaluator::apply_macro(const ALObjectPtr &func, const ALObjectPtr &args)
 {
     auto [params, body] = func->get_function();
@@ -306,8 +442,21 @@ ALObjectPtr Evaluator::apply_function(const ALObjectPtr &func, const ALObjectPtr
     try
     {
         auto [params, body] = func->get_function();
-        handle_argument_bindings(params, args, [&](auto param, auto arg) { put_argument(param, arg); });
-        return eval_list(this, body, 0);
+        handle_argument_bindings(params, args, [&](auto param, auto arg) { bind_argument(param, arg); });
+        if (m_vm != nullptr)
+        {
+            detail::FlowScope scope{ *this, detail::FlowScope::Kind::BARRIER };
+            return m_vm->eval_body(body);
+        }
+
+        detail::FlowScope scope{ *this, detail::FlowScope::Kind::FUNCTION };
+        auto res = eval_list_tail(this, body, 0);
+        if (m_unwind == Unwind::RETURN)
+        {
+            m_unwind = Unwind::NONE;
+            return std::exchange(m_unwind_value, nullptr);
+        }
+        return res;
     }
     catch (al_return &ret)
     {
@@ -315,43 +464,54 @@ ALObjectPtr Evaluator::apply_function(const ALObjectPtr &func, const ALObjectPtr
     }
 }
 
-ALObjectPtr Evaluator::apply_prime(const ALObjectPtr &func, const ALObjectPtr &args, const ALObjectPtr &)
+ALObjectPtr Evaluator::call_function(const ALObjectPtr &func, const ALObjectPtr &args)
 {
+    auto callee    = func;
+    auto call_args = args;
+
+    ALObject::list_type tail_args;
+    std::optional<ALObject> tail_view;
 
-    auto func_args = [&] {
-        if (func->prop_exists("--managed--"))
+    while (true)
+    {
         {
-            auto eval_args = eval_transform(this, args);
-            eval_args->set_prop("--evaled--", Qt);
-            return eval_args;
+            env::detail::FunctionCall fc{ env, callee };
+            auto res = apply_function(callee, call_args);
+            if (m_tail_callee == nullptr)
+            {
+                return res;
+            }
         }
 
-        args->set_prop("--evaled--", Qnil);
-        return args;
-    }();
+        // the arguments of the previous iteration are bound by now
+        callee = std::exchange(m_tail_callee, nullptr);
+        tail_args.swap(m_tail_args);
+        tail_view.emplace(std::begin(tail_args), std::end(tail_args));
+        call_args = ::alisp::detail::ALObjectHelper::init_ptr_borrowed(&*tail_view);
+    }
+}
 
-    if (func->prop_exists("--signature--"))
-    {
-        size_t cnt                                     = 1;
-        ALObject::list_type::difference_type opt_index = -1;
-        auto signature                                 = func->get_prop("--signature--");
-        auto opt_it                                    = std::find(signature->begin(), signature->end(), Qoptional);
+ALObjectPtr Evaluator::apply_prime(const ALObjectPtr &func, const ALObjectPtr &args, const CallSiteCache &site)
+{
+
+    auto call = [&](const ALObjectPtr &func_args) {
+        func_args->set_evaled_flag();
 
-        if (opt_it != std::end(*signature))
+        if (site.bounds != nullptr)
         {
-            opt_index = std::distance(signature->begin(), opt_it);
+            check_argument_count(*site.bounds, func_args->length());
         }
 
-        handle_argument_bindings(signature, func_args, [&](const auto &param, auto arg) {
-            if (opt_index != -1 and static_cast<ALObject::list_type::difference_type>(cnt) > opt_index + 1
-                and arg != Qnil)
-            {
-                SignatureHandler::handle_signature_element(param, arg, cnt++, signature);
-            }
-        });
+        return func->get_prime()(func_args, &env, this);
+    };
+
+    if (site.managed)
+    {
+        ArgumentWindow eval_args{ *this, args };
+        return call(eval_args.values());
     }
 
-    return func->get_prime()(func_args, &env, this);
+    return call(args);
 }
 
 ALObjectPtr Evaluator::eval_file(const std::string &t_file)
@@ -476,6 +636,50 @@ const std::string &Evaluator::get_current_file()
     return m_current_file;
 }
 
+ArgumentWindow::ArgumentWindow(Evaluator &t_eval, const ALObjectPtr &t_args)
+  : m_eval(t_eval), m_base(std::size(t_eval.m_value_stack))
+{
+    auto &stack      = m_eval.m_value_stack;
+    const auto first = std::begin(*t_args);
+    const auto last  = std::end(*t_args);
+    const auto count = static_cast<size_t>(std::distance(first, last));
+
+    if (m_base + count > stack.capacity())
+    {
+        m_values = eval_transform(&m_eval, t_args);
+        return;
+    }
+
+    // the windows of the calls made while evaluating the arguments are
+    // above this one and are gone by the time the next slot is filled
+    stack.resize(m_base + count);
+    try
+    {
+        auto slot = m_base;
+        for (auto it = first; it != last; ++it)
+        {
+            stack[slot++] = m_eval.eval(*it);
+        }
+    }
+    catch (...)
+    {
+        stack.resize(m_base);
+        throw;
+    }
+
+    const auto window = std::next(std::begin(stack), static_cast<std::ptrdiff_t>(m_base));
+    m_view.emplace(window, std::next(window, static_cast<std::ptrdiff_t>(count)));
+    m_values = ::alisp::detail::ALObjectHelper::init_ptr_borrowed(&*m_view);
+}
+
+ArgumentWindow::~ArgumentWindow()
+{
+    if (m_view)
+    {
+        m_eval.m_value_stack.resize(m_base);
+    }
+}
+
 detail::EvalDepthTrack::EvalDepthTrack(Evaluator &t_eval) : m_eval(t_eval)
 {
     m_eval.check_status();
@@ -502,6 +706,61 @@ detail::CatchTrack::~CatchTrack()
     --m_eval.m_catching_depth;
 }
 
+detail::FlowScope::FlowScope(Evaluator &t_eval, Kind t_kind)
+  : m_eval(t_eval)
+  , m_return_chain(t_eval.m_return_chain)
+  , m_loop_chain(t_eval.m_loop_chain)
+  , m_tail_chain(t_eval.m_tail_chain)
+{
+    switch (t_kind)
+    {
+        case Kind::STATEMENT: {
+            // the statement is evaluated one level deeper than the form
+            // that evaluates it
+            if (m_return_chain == m_eval.m_eval_depth)
+            {
+                ++m_eval.m_return_chain;
+            }
+            if (m_loop_chain == m_eval.m_eval_depth)
+            {
+                ++m_eval.m_loop_chain;
+            }
+            break;
+        }
+        case Kind::FUNCTION: {
+            m_eval.m_return_chain = m_eval.m_eval_depth;
+            m_eval.m_loop_chain   = Evaluator::NO_CHAIN;
+            m_eval.m_tail_chain   = m_eval.m_eval_depth;
+            break;
+        }
+        case Kind::LOOP: {
+            m_eval.m_loop_chain = m_eval.m_eval_depth;
+            break;
+        }
+        case Kind::BARRIER: {
+            m_eval.m_return_chain = Evaluator::NO_CHAIN;
+            m_eval.m_loop_chain   = Evaluator::NO_CHAIN;
+            m_eval.m_tail_chain   = Evaluator::NO_CHAIN;
+            break;
+        }
+        case Kind::TAIL: {
+            // the form is evaluated one level deeper, like a statement
+            if (m_tail_chain == m_eval.m_eval_depth)
+            {
+                ++m_eval.m_tail_chain;
+            }
+            break;
+        }
+    }
+}
+
+detail::FlowScope::~FlowScope()
+{
+    m_eval.m_return_chain = m_return_chain;
+    m_eval.m_loop_chain   = m_loop_chain;
+    m_eval.m_tail_chain   = m_tail_chain;
+}
+
 detail::EvaluationLock::EvaluationLock(Evaluator &t_eval) : m_eval(t_eval)
 {
     t_eval.lock_evaluation();
@@ -0,0 +1,138 @@
+/*   Alisp - the alisp interpreted language
+     Copyright (C) 2020 Stanislav Arnaudov
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any prior version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along
+ with this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#include "alisp/alisp/alisp_gc.hpp"
+
+#ifdef USE_GC_MEMORY
+
+#include <algorithm>
+
+namespace alisp
+{
+
+namespace gc
+{
+
+void Heap::add_roots(const void *t_owner, tracer_type t_tracer, pruner_type t_pruner)
+{
+    std::lock_guard<std::mutex> guard{ m_lock };
+    m_roots.push_back({ t_owner, std::move(t_tracer), std::move(t_pruner) });
+}
+
+void Heap::remove_roots(const void *t_owner)
+{
+    std::lock_guard<std::mutex> guard{ m_lock };
+    m_roots.erase(std::remove_if(std::begin(m_roots),
+                                 std::end(m_roots),
+                                 [t_owner](const RootSet &t_set) { return t_set.owner == t_owner; }),
+                  std::end(m_roots));
+}
+
+void Heap::seal()
+{
+    std::lock_guard<std::mutex> guard{ m_lock };
+    if (m_sealed)
+    {
+        return;
+    }
+
+    for_each_live([this](size_t t_block, size_t t_index) {
+        auto obj = slot(t_block, t_index);
+        obj->set_permanent_flag();
+        m_permanent.push_back(obj);
+    });
+    m_sealed = true;
+}
+
+size_t Heap::collect()
+{
+    std::lock_guard<std::mutex> guard{ m_lock };
+
+    Marker marker;
+    for (auto obj : m_permanent)
+    {
+        obj->visit_references([&marker](ALObject *t_ref) { marker.mark(t_ref); });
+    }
+    for (auto &root : m_roots)
+    {
+        root.tracer(marker);
+    }
+    marker.drain();
+
+    for (auto &root : m_roots)
+    {
+        if (root.pruner)
+        {
+            root.pruner();
+        }
+    }
+
+    size_t freed = 0;
+    for_each_live([this, &freed](size_t t_block, size_t t_index) {
+        auto obj = slot(t_block, t_index);
+        if (obj->check_mark_flag())
+        {
+            obj->reset_mark_flag();
+            return;
+        }
+
+        if (obj->check_permanent_flag() or obj->check_immediate_flag())
+        {
+            return;
+        }
+
+        obj->~ALObject();
+        m_blocks[t_block].live[t_index] = false;
+        m_free.emplace_back(static_cast<std::uint32_t>(t_block), static_cast<std::uint32_t>(t_index));
+        ++freed;
+    });
+
+    m_live -= freed;
+    m_freed += freed;
+    ++m_collections;
+    m_allocated = 0;
+    m_threshold = std::max(MIN_THRESHOLD, m_live);
+
+    return freed;
+}
+
+void Heap::safepoint()
+{
+    if (m_sealed and m_allocated >= m_threshold)
+    {
+        collect();
+    }
+}
+
+Heap::Stats Heap::stats()
+{
+    std::lock_guard<std::mutex> guard{ m_lock };
+    return { std::size(m_blocks), m_live, m_collections, m_freed };
+}
+
+Heap &heap()
+{
+    // never destroyed so that objects in other static storage can outlive it
+    static auto *instance = new Heap;
+    return *instance;
+}
+
+}  // namespace gc
+
+}  // namespace alisp
+
+#endif
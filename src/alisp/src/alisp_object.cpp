@@ -16,35 +16,140 @@
  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
 
 
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <memory>
+
 #include "alisp/alisp/alisp_common.hpp"
 #include "alisp/alisp/alisp_object.hpp"
 #include "alisp/utility.hpp"
+#include "alisp/utility/containers.hpp"
 
 
 namespace alisp
 {
 
-ALObjectPtr env::intern(std::string name)
+namespace
 {
 
-    if (env::Environment::g_internal_symbols.count(name))
+// The ids are handed out in the order in which the names are first seen;
+// the deque keeps the names in place while it grows.
+struct SymbolNames
+{
+    FlatMap<std::string, env::SymbolId> ids;
+    std::deque<std::string> names;
+
+    static SymbolNames &get()
     {
-        return env::Environment::g_internal_symbols.at(name);
+        static SymbolNames symbol_names;
+        return symbol_names;
     }
+};
+
+// The objects on the GC heap outlive every other static, so the table is
+// never destroyed.
+struct SourceLocations
+{
+    FlatMap<const ALObject *, SourceLocation> forms;
+    FlatMap<std::string, std::uint32_t> ids;
+    std::deque<std::string> files;
 
-    if (env::Environment::g_user_symbols.count(name))
+    static SourceLocations &get()
     {
-        return env::Environment::g_user_symbols.at(name);
+        static auto *locations = new SourceLocations;
+        return *locations;
     }
+};
 
-    auto [new_sym, insertion] = env::Environment::g_user_symbols.insert({ name, make_symbol(name) });
+}  // namespace
 
-    return new_sym->second;
+void SourceMap::add(ALObject *t_form, SourceLocation t_location)
+{
+    SourceLocations::get().forms[t_form] = t_location;
+    t_form->set_located_flag();
+}
+
+const SourceLocation *SourceMap::find(const ALObject *t_form)
+{
+    auto &forms = SourceLocations::get().forms;
+    if (auto it = forms.find(t_form); it != std::end(forms))
+    {
+        return &it->second;
+    }
+    return nullptr;
+}
+
+void SourceMap::forget(const ALObject *t_form)
+{
+    SourceLocations::get().forms.erase(t_form);
+}
+
+std::uint32_t SourceMap::file_id(const std::string &t_file)
+{
+    auto &table = SourceLocations::get();
+
+    if (auto it = table.ids.find(t_file); it != std::end(table.ids))
+    {
+        return it->second;
+    }
+
+    const auto id = static_cast<std::uint32_t>(std::size(table.files));
+    table.files.push_back(t_file);
+    table.ids.insert({ t_file, id });
+    return id;
+}
+
+const std::string &SourceMap::file_name(std::uint32_t t_id)
+{
+    return SourceLocations::get().files.at(t_id);
+}
+
+env::SymbolId env::symbol_id(const std::string &t_name)
+{
+    auto &table = SymbolNames::get();
+
+    if (auto it = table.ids.find(t_name); it != std::end(table.ids))
+    {
+        return it->second;
+    }
+
+    const auto id = static_cast<env::SymbolId>(std::size(table.names));
+    table.names.push_back(t_name);
+    table.ids.insert({ t_name, id });
+    return id;
+}
+
+const std::string &env::symbol_name(env::SymbolId t_id)
+{
+    return SymbolNames::get().names.at(t_id);
+}
+
+ALObjectPtr env::intern(std::string name)
+{
+    const auto id = env::symbol_id(name);
+
+    if (auto it = env::Environment::g_internal_symbols.find(id); it != std::end(env::Environment::g_internal_symbols))
+    {
+        return it->second;
+    }
+
+    if (auto it = env::Environment::g_user_symbols.find(id); it != std::end(env::Environment::g_user_symbols))
+    {
+        return it->second;
+    }
+
+    return env::Environment::g_user_symbols.insert({ id, make_symbol(name) }).first->second;
 }
 
 void env::update_prime(const ALObjectPtr &t_sym, ALObjectPtr t_val)
 {
-    env::Environment::g_prime_values.at(t_sym->to_string()) = std::move(t_val);
+    auto &cell = env::Environment::g_prime_values.at(t_sym->symbol_id());
+    if (cell->check_function_flag() or t_val->check_function_flag())
+    {
+        env::Environment::invalidate_call_sites();
+    }
+    cell = std::move(t_val);
 }
 
 
@@ -58,5 +163,67 @@ ALObjectPtr resource_to_object(uint32_t t_id)
     return make_int(static_cast<ALObject::int_type>(t_id));
 }
 
+ALObjectPtr ALObject::range_element(const range_type &t_range, size_t t_index)
+{
+    return make_int(t_range.from + static_cast<int_type>(t_index) * t_range.step);
+}
+
+ALObjectPtr ALObject::sublist(size_t t_begin, size_t t_end) const
+{
+    if (t_begin >= t_end)
+    {
+        return make_object(list_type{});
+    }
+
+    if (const auto slice = std::get_if<slice_type>(&m_data))
+    {
+        return make_object(slice_type{ slice->elements, slice->begin + t_begin, slice->begin + t_end });
+    }
+
+    if (const auto range = std::get_if<range_type>(&m_data))
+    {
+        const auto from = range->from + static_cast<int_type>(t_begin) * range->step;
+        const auto to   = std::min(range->to, range->from + static_cast<int_type>(t_end) * range->step);
+        return make_object(range_type{ from, to, range->step });
+    }
+
+    const auto hops = static_cast<list_type::difference_type>(t_begin);
+    const auto size = static_cast<list_type::difference_type>(t_end - t_begin);
+    auto elements   = std::make_shared<list_type>(std::next(begin(), hops), std::next(begin(), hops + size));
+    return make_object(slice_type{ std::move(elements), 0, t_end - t_begin });
+}
+
+void ALObject::materialize()
+{
+    if (auto slice = std::get_if<slice_type>(&m_data))
+    {
+        auto &shared     = *slice->elements;
+        const auto first = std::next(std::begin(shared), static_cast<list_type::difference_type>(slice->begin));
+        const auto last  = std::next(std::begin(shared), static_cast<list_type::difference_type>(slice->end));
+
+        // nobody else sees the elements, so they can be taken instead of copied
+        if (slice->elements.use_count() == 1)
+        {
+            list_type elements{ std::make_move_iterator(first), std::make_move_iterator(last) };
+            m_data = std::move(elements);
+            return;
+        }
+
+        m_data = list_type(first, last);
+        return;
+    }
+
+    const auto range = std::get<range_type>(m_data);
+
+    list_type elements;
+    elements.reserve(range.size());
+    for (auto i = range.from; i < range.to; i += range.step)
+    {
+        elements.push_back(make_int(i));
+    }
+
+    m_data = std::move(elements);
+}
+
 
 }  // namespace alisp
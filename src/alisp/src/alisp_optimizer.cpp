@@ -31,26 +31,70 @@ ALObjectPtr MainOptimizer::do_optimize(const ALObjectPtr &t_obj)
         return t_obj;
     }
 
-    for (auto el : *t_obj)
+    const auto bindings = detail::bindings(t_obj);
+    const bool shadows  = bindings != nullptr and m_opt.binds_constant(t_obj);
+    m_opt.shadowed += shadows ? 1 : 0;
+
+    for (auto &el : t_obj->children())
     {
         if (!plist(el))
         {
             continue;
         }
-        el = do_optimize(el);
+
+        if (el != bindings)
+        {
+            el = do_optimize(el);
+            continue;
+        }
+
+        detail::for_each_binding(t_obj, [&](const ALObjectPtr &binding) {
+            if (!plist(binding))
+            {
+                return;
+            }
+
+            for (auto it = std::next(std::begin(binding->children())); it != std::end(binding->children()); ++it)
+            {
+                if (plist(*it))
+                {
+                    *it = do_optimize(*it);
+                }
+            }
+        });
     }
 
     auto res = m_opt.optimize(t_obj);
+    m_opt.shadowed -= shadows ? 1 : 0;
     return res;
 }
 
-void MainOptimizer::optimize(std::vector<ALObjectPtr> &t_objs)
+void MainOptimizer::optimize(std::vector<ALObjectPtr> &t_objs, Level t_level)
 {
+    if (t_level == Level::NONE)
+    {
+        return;
+    }
+
+    m_opt.enabled = t_level == Level::ALGEBRAIC;
+    m_opt.constants.clear();
+    m_opt.shadowed = 0;
+    m_opt.functions.clear();
+    m_opt.definitions.clear();
+    m_opt.references.clear();
+
+    for (auto &obj : t_objs)
+    {
+        if (plist(obj)) m_opt.scan(obj);
+    }
 
     for (auto &obj : t_objs)
     {
         if (!plist(obj)) continue;
         obj = do_optimize(obj);
+        if (!plist(obj)) continue;
+        m_opt.define(obj);
+        m_opt.declare(obj);
     }
 }
 
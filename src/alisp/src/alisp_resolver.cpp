@@ -0,0 +1,418 @@
+/*   Alisp - the alisp interpreted language
+     Copyright (C) 2020 Stanislav Arnaudov
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any prior version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along
+ with this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#include "alisp/alisp/alisp_resolver.hpp"
+#include "alisp/alisp/alisp_object.hpp"
+#include "alisp/alisp/alisp_factory.hpp"
+
+#include "alisp/alisp/declarations/constants.hpp"
+#include "alisp/alisp/declarations/language_constructs.hpp"
+
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace alisp
+{
+
+namespace env
+{
+
+namespace
+{
+
+class Resolver
+{
+  public:
+    Resolver(Environment &t_env, const std::string &t_name) : m_env(t_env), m_name(t_name) {}
+
+    void function(const ALObjectPtr &t_params, const ALObjectPtr &t_body)
+    {
+        if (plist(t_params))
+        {
+            for (auto &param : *t_params)
+            {
+                if (param != Qoptional and param != Qrest)
+                {
+                    param = bind(param);
+                }
+            }
+        }
+
+        sequence(t_body, 0);
+    }
+
+  private:
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+    struct Binding
+    {
+        ALObjectPtr symbol;
+        size_t slot;
+        size_t scope;
+    };
+
+    Environment &m_env;
+    const std::string &m_name;
+
+    std::vector<Binding> m_bindings;
+    std::unordered_map<SymbolId, ALObjectPtr> m_globals;
+    size_t m_cells{ 0 };
+    size_t m_scope{ 0 };
+
+    static ALObjectPtr &at(const ALObjectPtr &t_list, size_t t_index)
+    {
+        return *std::next(std::begin(*t_list), static_cast<std::ptrdiff_t>(t_index));
+    }
+
+    const Binding *binding(SymbolId t_id) const
+    {
+        for (auto it = std::rbegin(m_bindings); it != std::rend(m_bindings); ++it)
+        {
+            if (it->symbol->symbol_id() == t_id)
+            {
+                return &(*it);
+            }
+        }
+        return nullptr;
+    }
+
+    ALObjectPtr global(SymbolId t_id)
+    {
+        if (auto it = Environment::g_prime_values.find(t_id); it != std::end(Environment::g_prime_values))
+        {
+            return it->second;
+        }
+
+        auto &root = m_env.current_module_ref().root_scope();
+        if (auto it = root.find(t_id); it != std::end(root))
+        {
+            return it->second;
+        }
+
+        auto &main_root = m_env.get_module("--main--")->root_scope();
+        if (auto it = main_root.find(t_id); it != std::end(main_root))
+        {
+            return it->second;
+        }
+
+        return nullptr;
+    }
+
+    ALObjectPtr bind(const ALObjectPtr &t_sym)
+    {
+        if (!psym(t_sym))
+        {
+            return t_sym;
+        }
+
+        const auto &name = t_sym->to_string();
+
+        for (auto it = std::rbegin(m_bindings); it != std::rend(m_bindings) and it->scope == m_scope; ++it)
+        {
+            if (it->symbol->symbol_id() == t_sym->symbol_id())
+            {
+                return it->symbol;
+            }
+        }
+
+        const auto slot = m_cells++;
+        if (slot + 1 >= ALObject::GLOBAL_LOCATION)
+        {
+            m_bindings.push_back({ t_sym, npos, m_scope });
+            return t_sym;
+        }
+
+        auto local = make_symbol(name);
+        local->set_location(static_cast<std::uint32_t>(slot + 1));
+        m_bindings.push_back({ local, slot, m_scope });
+        return local;
+    }
+
+    void reference(ALObjectPtr &t_sym)
+    {
+        if (t_sym == Qt or t_sym == Qnil or t_sym->get_location() != 0)
+        {
+            return;
+        }
+
+        const auto &name = t_sym->to_string();
+        if (name.front() == ':')
+        {
+            return;
+        }
+
+        if (auto local = binding(t_sym->symbol_id()); local != nullptr)
+        {
+            if (local->slot != npos)
+            {
+                t_sym = local->symbol;
+            }
+            return;
+        }
+
+        auto &global = m_globals[t_sym->symbol_id()];
+        if (!global)
+        {
+            global = make_symbol(name);
+            global->set_location(ALObject::GLOBAL_LOCATION);
+        }
+        t_sym = global;
+    }
+
+    template<typename Callable> void scope(Callable &&t_inner)
+    {
+        const auto bindings = std::size(m_bindings);
+        const auto cells    = m_cells;
+        ++m_scope;
+
+        t_inner();
+
+        --m_scope;
+        m_bindings.erase(std::next(std::begin(m_bindings), static_cast<std::ptrdiff_t>(bindings)),
+                         std::end(m_bindings));
+        m_cells = cells;
+    }
+
+    void sequence(const ALObjectPtr &t_list, size_t t_offset)
+    {
+        if (!plist(t_list))
+        {
+            return;
+        }
+
+        const auto len = t_list->length();
+        for (size_t i = t_offset; i < len; ++i)
+        {
+            expression(at(t_list, i));
+        }
+    }
+
+    void expression(ALObjectPtr &t_obj)
+    {
+        if (psym(t_obj))
+        {
+            reference(t_obj);
+            return;
+        }
+
+        if (!plist(t_obj) or is_falsy(t_obj) or pprime(t_obj))
+        {
+            return;
+        }
+
+        auto &head = at(t_obj, 0);
+
+        if (pprime(head))
+        {
+            prime(head, t_obj);
+            return;
+        }
+
+        if (!psym(head))
+        {
+            return;
+        }
+
+        if (binding(head->symbol_id()) != nullptr)
+        {
+            sequence(t_obj, 0);
+            return;
+        }
+
+        auto callee = global(head->symbol_id());
+        if (callee and pprime(callee))
+        {
+            reference(head);
+            prime(callee, t_obj);
+            return;
+        }
+
+        const bool function = callee ? (pfunction(callee) and !callee->check_macro_flag())
+                                     : (!m_name.empty() and head->to_string() == m_name);
+        if (function)
+        {
+            sequence(t_obj, 0);
+        }
+    }
+
+    void prime(const ALObjectPtr &t_prime, const ALObjectPtr &t_form)
+    {
+        const auto len = t_form->length();
+
+        if (t_prime == Pquote or t_prime == Pfunction or t_prime == Pbackquote or t_prime == Plambda
+            or t_prime == Pdefun or t_prime == Pdefmacro or t_prime == Pdefvar or t_prime == Pdefconst
+            or t_prime == Pimport or t_prime == Pmodref)
+        {
+            return;
+        }
+
+        if (t_prime == Psetq)
+        {
+            for (size_t i = 1; i < len; i += 2)
+            {
+                if (psym(at(t_form, i)))
+                {
+                    reference(at(t_form, i));
+                }
+                if (i + 1 < len)
+                {
+                    expression(at(t_form, i + 1));
+                }
+            }
+            return;
+        }
+
+        if (t_prime == Pcond)
+        {
+            for (size_t i = 1; i < len; ++i)
+            {
+                sequence(at(t_form, i), 0);
+            }
+            return;
+        }
+
+        if (t_prime == Pcondition_case)
+        {
+            if (len > 2)
+            {
+                expression(at(t_form, 2));
+            }
+            return;
+        }
+
+        if (t_prime == Plet)
+        {
+            let(t_form, false);
+            return;
+        }
+
+        if (t_prime == Pletx)
+        {
+            let(t_form, true);
+            return;
+        }
+
+        if (t_prime == Pdolist or t_prime == Pdotimes)
+        {
+            loop(t_form);
+            return;
+        }
+
+        sequence(t_form, 1);
+    }
+
+    void let(const ALObjectPtr &t_form, bool t_sequential)
+    {
+        if (t_form->length() < 2)
+        {
+            return;
+        }
+
+        auto &varlist = at(t_form, 1);
+
+        if (psym(varlist))
+        {
+            // (let sym val) puts the variable in the current scope of the
+            // frame; it is looked up dynamically
+            if (t_form->length() == 3)
+            {
+                expression(at(t_form, 2));
+            }
+            return;
+        }
+
+        if (!plist(varlist))
+        {
+            return;
+        }
+
+        for (auto &var : *varlist)
+        {
+            if (!(psym(var) or (plist(var) and var->length() == 2 and psym(var->i(0)))))
+            {
+                return;
+            }
+        }
+
+        if (!t_sequential)
+        {
+            for (auto &var : *varlist)
+            {
+                if (plist(var))
+                {
+                    expression(at(var, 1));
+                }
+            }
+        }
+
+        scope([&]() {
+            for (auto &var : *varlist)
+            {
+                if (psym(var))
+                {
+                    var = bind(var);
+                    continue;
+                }
+
+                if (t_sequential)
+                {
+                    expression(at(var, 1));
+                }
+                at(var, 0) = bind(var->i(0));
+            }
+
+            sequence(t_form, 2);
+        });
+    }
+
+    void loop(const ALObjectPtr &t_form)
+    {
+        if (t_form->length() < 2)
+        {
+            return;
+        }
+
+        auto &spec = at(t_form, 1);
+        if (!plist(spec) or spec->length() != 2 or !psym(spec->i(0)))
+        {
+            return;
+        }
+
+        expression(at(spec, 1));
+
+        scope([&]() {
+            at(spec, 0) = bind(spec->i(0));
+            sequence(t_form, 2);
+        });
+    }
+};
+
+}  // namespace
+
+void resolve_function(Environment &t_env,
+                      const ALObjectPtr &t_params,
+                      const ALObjectPtr &t_body,
+                      const std::string &t_name)
+{
+    Resolver resolver{ t_env, t_name };
+    resolver.function(t_params, t_body);
+}
+
+}  // namespace env
+
+}  // namespace alisp
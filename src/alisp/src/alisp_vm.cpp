@@ -0,0 +1,744 @@
+/*   Alisp - the alisp interpreted language
+     Copyright (C) 2020 Stanislav Arnaudov
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any prior version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along
+ with this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+#include "alisp/alisp/alisp_vm.hpp"
+#include "alisp/alisp/alisp_object.hpp"
+#include "alisp/alisp/alisp_factory.hpp"
+#include "alisp/alisp/alisp_exception.hpp"
+#include "alisp/alisp/alisp_gc.hpp"
+
+#include "alisp/alisp/declarations/constants.hpp"
+#include "alisp/alisp/declarations/language_constructs.hpp"
+#include "alisp/alisp/declarations/logic.hpp"
+
+#include <sstream>
+#include <iomanip>
+
+namespace alisp
+{
+
+namespace vm
+{
+
+namespace
+{
+
+ALObjectPtr resolve_prime(const ALObjectPtr &t_head)
+{
+    if (pprime(t_head))
+    {
+        return t_head;
+    }
+
+    if (!psym(t_head))
+    {
+        return nullptr;
+    }
+
+    auto it = env::Environment::g_prime_values.find(t_head->symbol_id());
+    if (it == std::end(env::Environment::g_prime_values) or !pprime(it->second))
+    {
+        return nullptr;
+    }
+
+    return it->second;
+}
+
+class Compiler
+{
+  public:
+    explicit Compiler(Chunk &t_chunk) : m_chunk(t_chunk) {}
+
+    void expression(const ALObjectPtr &t_obj)
+    {
+        if (is_falsy(t_obj))
+        {
+            emit(OpCode::PUSH_CONST, constant(t_obj));
+            return;
+        }
+
+        switch (t_obj->type())
+        {
+            case ALObjectType::SYMBOL: {
+                if (t_obj->to_string().front() == ':')
+                {
+                    emit(OpCode::PUSH_CONST, constant(t_obj));
+                }
+                else
+                {
+                    emit(OpCode::LOAD_SYM, constant(t_obj));
+                }
+                return;
+            }
+
+            case ALObjectType::LIST: {
+                if (pprime(t_obj))
+                {
+                    emit(OpCode::PUSH_CONST, constant(t_obj));
+                }
+                else
+                {
+                    form(t_obj);
+                }
+                return;
+            }
+
+            default: {
+                emit(OpCode::PUSH_CONST, constant(t_obj));
+                return;
+            }
+        }
+    }
+
+    void sequence(const ALObjectPtr &t_list, size_t t_offset)
+    {
+        const auto len = t_list->length();
+        if (t_offset >= len)
+        {
+            emit(OpCode::PUSH_CONST, constant(Qt));
+            return;
+        }
+
+        for (size_t i = t_offset; i < len; ++i)
+        {
+            expression(t_list->i(i));
+            if (i + 1 < len)
+            {
+                emit(OpCode::POP);
+            }
+        }
+    }
+
+    void finish() { emit(OpCode::RETURN); }
+
+  private:
+    Chunk &m_chunk;
+
+    std::uint32_t here() const { return static_cast<std::uint32_t>(std::size(m_chunk.code)); }
+
+    std::uint32_t emit(OpCode t_op, std::uint32_t t_arg = 0)
+    {
+        m_chunk.code.push_back({ t_op, t_arg });
+        return here() - 1;
+    }
+
+    void patch(std::uint32_t t_at) { m_chunk.code[t_at].arg = here(); }
+
+    std::uint32_t constant(ALObjectPtr t_obj)
+    {
+        m_chunk.constants.push_back(std::move(t_obj));
+        return static_cast<std::uint32_t>(std::size(m_chunk.constants) - 1);
+    }
+
+    std::uint32_t call_site(const ALObjectPtr &t_form, ALObjectPtr t_callee)
+    {
+        m_chunk.calls.push_back(
+          { t_form, std::move(t_callee), splice(t_form, 1), static_cast<std::uint32_t>(t_form->length() - 1), 0 });
+        return static_cast<std::uint32_t>(std::size(m_chunk.calls) - 1);
+    }
+
+    std::uint32_t loop(const ALObjectPtr &t_form, ALObjectPtr t_sym, const ALObjectPtr &t_head, size_t t_body)
+    {
+        m_chunk.loops.push_back({ t_form, std::move(t_sym), compile(t_head), compile_body(t_form, t_body) });
+        return static_cast<std::uint32_t>(std::size(m_chunk.loops) - 1);
+    }
+
+    void form(const ALObjectPtr &t_obj)
+    {
+        const auto &head = t_obj->i(0);
+
+        if (auto prime = resolve_prime(head); prime != nullptr)
+        {
+            if (!special_form(prime, t_obj))
+            {
+                emit(OpCode::CALL_PRIME, call_site(t_obj, prime));
+            }
+            return;
+        }
+
+        if (!psym(head))
+        {
+            emit(OpCode::EVAL, constant(t_obj));
+            return;
+        }
+
+        const auto site = call_site(t_obj, head);
+        emit(OpCode::LOAD_FUNC, site);
+        for (size_t i = 1; i < t_obj->length(); ++i)
+        {
+            expression(t_obj->i(i));
+        }
+        emit(OpCode::CALL, site);
+        m_chunk.calls[site].end = here();
+    }
+
+    bool special_form(const ALObjectPtr &t_prime, const ALObjectPtr &t_obj)
+    {
+        const auto argc = t_obj->length() - 1;
+
+        if (t_prime == Pquote)
+        {
+            if (argc != 1)
+            {
+                return false;
+            }
+            emit(OpCode::PUSH_CONST, constant(t_obj->i(1)));
+            return true;
+        }
+
+        if (t_prime == Pprogn)
+        {
+            sequence(t_obj, 1);
+            return true;
+        }
+
+        if (t_prime == Pif)
+        {
+            if (argc < 2)
+            {
+                return false;
+            }
+            expression(t_obj->i(1));
+            const auto else_jump = emit(OpCode::JUMP_IF_NIL);
+            expression(t_obj->i(2));
+            const auto end_jump = emit(OpCode::JUMP);
+            patch(else_jump);
+            if (argc >= 3)
+            {
+                sequence(t_obj, 3);
+            }
+            else
+            {
+                emit(OpCode::PUSH_CONST, constant(Qnil));
+            }
+            patch(end_jump);
+            return true;
+        }
+
+        if (t_prime == Pwhen or t_prime == Punless)
+        {
+            if (argc < 2)
+            {
+                return false;
+            }
+            expression(t_obj->i(1));
+            const auto skip_jump = emit(t_prime == Pwhen ? OpCode::JUMP_IF_NIL : OpCode::JUMP_IF_NOT_NIL);
+            sequence(t_obj, 2);
+            const auto end_jump = emit(OpCode::JUMP);
+            patch(skip_jump);
+            emit(OpCode::PUSH_CONST, constant(Qnil));
+            patch(end_jump);
+            return true;
+        }
+
+        if (t_prime == Pand or t_prime == Por)
+        {
+            const auto short_op = t_prime == Pand ? OpCode::JUMP_IF_NIL : OpCode::JUMP_IF_NOT_NIL;
+            std::vector<std::uint32_t> jumps;
+            for (size_t i = 1; i <= argc; ++i)
+            {
+                expression(t_obj->i(i));
+                jumps.push_back(emit(short_op));
+            }
+            emit(OpCode::PUSH_CONST, constant(t_prime == Pand ? Qt : Qnil));
+            const auto end_jump = emit(OpCode::JUMP);
+            for (auto jump : jumps)
+            {
+                patch(jump);
+            }
+            emit(OpCode::PUSH_CONST, constant(t_prime == Pand ? Qnil : Qt));
+            patch(end_jump);
+            return true;
+        }
+
+        if (t_prime == Psetq)
+        {
+            if (argc < 2)
+            {
+                return false;
+            }
+            for (size_t i = 1; i <= argc; i += 2)
+            {
+                if (!psym(t_obj->i(i)))
+                {
+                    return false;
+                }
+            }
+            for (size_t i = 1; i <= argc; i += 2)
+            {
+                if (i + 1 > argc)
+                {
+                    emit(OpCode::PUSH_CONST, constant(Qnil));
+                    return true;
+                }
+                expression(t_obj->i(i + 1));
+                emit(OpCode::SET_SYM, constant(t_obj->i(i)));
+            }
+            emit(OpCode::PUSH_CONST, constant(Qt));
+            return true;
+        }
+
+        if (t_prime == Pwhile)
+        {
+            if (argc < 1)
+            {
+                return false;
+            }
+            emit(OpCode::WHILE, loop(t_obj, Qnil, t_obj->i(1), 2));
+            return true;
+        }
+
+        if (t_prime == Pdolist)
+        {
+            if (argc < 1 or !plist(t_obj->i(1)) or t_obj->i(1)->length() < 2 or !psym(t_obj->i(1)->i(0)))
+            {
+                return false;
+            }
+            emit(OpCode::DOLIST, loop(t_obj, t_obj->i(1)->i(0), t_obj->i(1)->i(1), 2));
+            return true;
+        }
+
+        return false;
+    }
+};
+
+class StackWindow
+{
+  public:
+    explicit StackWindow(std::vector<ALObjectPtr> &t_stack) : m_stack(t_stack), m_base(std::size(t_stack)) {}
+    ~StackWindow() { m_stack.resize(m_base); }
+
+    ALISP_RAII_OBJECT(StackWindow);
+
+  private:
+    std::vector<ALObjectPtr> &m_stack;
+    size_t m_base;
+};
+
+constexpr const char *opcode_name(OpCode t_op)
+{
+    switch (t_op)
+    {
+        case OpCode::PUSH_CONST: return "PUSH_CONST";
+        case OpCode::LOAD_SYM: return "LOAD_SYM";
+        case OpCode::SET_SYM: return "SET_SYM";
+        case OpCode::POP: return "POP";
+        case OpCode::JUMP: return "JUMP";
+        case OpCode::JUMP_IF_NIL: return "JUMP_IF_NIL";
+        case OpCode::JUMP_IF_NOT_NIL: return "JUMP_IF_NOT_NIL";
+        case OpCode::CALL_PRIME: return "CALL_PRIME";
+        case OpCode::LOAD_FUNC: return "LOAD_FUNC";
+        case OpCode::CALL: return "CALL";
+        case OpCode::EVAL: return "EVAL";
+        case OpCode::WHILE: return "WHILE";
+        case OpCode::DOLIST: return "DOLIST";
+        case OpCode::RETURN: return "RETURN";
+    }
+    return "UNKNOWN";
+}
+
+}  // namespace
+
+
+std::unique_ptr<Chunk> compile(const ALObjectPtr &t_obj)
+{
+    auto chunk = std::make_unique<Chunk>();
+    Compiler compiler{ *chunk };
+    compiler.expression(t_obj);
+    compiler.finish();
+    return chunk;
+}
+
+std::unique_ptr<Chunk> compile_body(const ALObjectPtr &t_body, size_t t_offset)
+{
+    auto chunk = std::make_unique<Chunk>();
+    Compiler compiler{ *chunk };
+    compiler.sequence(t_body, t_offset);
+    compiler.finish();
+    return chunk;
+}
+
+std::string disassemble(const Chunk &t_chunk)
+{
+    std::ostringstream out;
+    for (size_t i = 0; i < std::size(t_chunk.code); ++i)
+    {
+        const auto &ins = t_chunk.code[i];
+        out << std::setw(4) << std::setfill('0') << i << ' ' << opcode_name(ins.op);
+        switch (ins.op)
+        {
+            case OpCode::PUSH_CONST:
+            case OpCode::LOAD_SYM:
+            case OpCode::SET_SYM:
+            case OpCode::EVAL: out << ' ' << dump(t_chunk.constants[ins.arg]); break;
+            case OpCode::CALL_PRIME:
+            case OpCode::LOAD_FUNC:
+            case OpCode::CALL: out << ' ' << dump(t_chunk.calls[ins.arg].form); break;
+            case OpCode::JUMP:
+            case OpCode::JUMP_IF_NIL:
+            case OpCode::JUMP_IF_NOT_NIL:
+            case OpCode::WHILE:
+            case OpCode::DOLIST: out << ' ' << ins.arg; break;
+            default: break;
+        }
+        out << '\n';
+    }
+    return out.str();
+}
+
+
+#ifdef USE_GC_MEMORY
+namespace
+{
+
+void mark_chunk(gc::Marker &t_marker, const Chunk &t_chunk)
+{
+    for (auto obj : t_chunk.constants)
+    {
+        t_marker.mark(obj);
+    }
+
+    for (auto &call : t_chunk.calls)
+    {
+        t_marker.mark(call.form);
+        t_marker.mark(call.callee);
+        t_marker.mark(call.args);
+    }
+
+    for (auto &loop : t_chunk.loops)
+    {
+        t_marker.mark(loop.form);
+        t_marker.mark(loop.symbol);
+        mark_chunk(t_marker, *loop.head);
+        mark_chunk(t_marker, *loop.body);
+    }
+}
+
+}  // namespace
+#endif
+
+VirtualMachine::VirtualMachine(env::Environment &t_env, eval::Evaluator &t_eval)
+  : m_env(t_env), m_eval(t_eval), m_sweep_threshold(256)
+{
+    m_stack.reserve(256);
+
+#ifdef USE_GC_MEMORY
+    // the cached chunks do not keep their bodies alive; the chunks of the
+    // bodies that did not survive a collection are dropped
+    gc::heap().add_roots(
+      this,
+      [this](gc::Marker &t_marker) {
+          for (auto obj : m_stack)
+          {
+              t_marker.mark(obj);
+          }
+          for (auto &[_, cached] : m_bodies)
+          {
+              mark_chunk(t_marker, *cached.chunk);
+          }
+      },
+      [this]() {
+          for (auto it = std::begin(m_bodies); it != std::end(m_bodies);)
+          {
+              it = it->second.body->check_mark_flag() ? std::next(it) : m_bodies.erase(it);
+          }
+      });
+#endif
+}
+
+VirtualMachine::~VirtualMachine()
+{
+#ifdef USE_GC_MEMORY
+    gc::heap().remove_roots(this);
+#endif
+}
+
+ALObjectPtr VirtualMachine::eval(const ALObjectPtr &t_obj)
+{
+    if (!plist(t_obj) or is_falsy(t_obj))
+    {
+        return m_eval.eval(t_obj);
+    }
+
+    auto chunk = compile(t_obj);
+    return run(*chunk);
+}
+
+ALObjectPtr VirtualMachine::eval_body(const ALObjectPtr &t_body)
+{
+    auto it = m_bodies.find(getraw(t_body));
+
+#ifdef USE_MANUAL_MEMORY
+    const bool stale = it == std::end(m_bodies);
+#else
+    const bool stale = it == std::end(m_bodies) or it->second.body.expired();
+#endif
+
+    if (stale)
+    {
+        if (std::size(m_bodies) >= m_sweep_threshold)
+        {
+            sweep();
+        }
+        it = m_bodies.insert_or_assign(getraw(t_body), CachedChunk{ t_body, compile_body(t_body) }).first;
+    }
+
+    return run(*it->second.chunk);
+}
+
+void VirtualMachine::sweep()
+{
+#ifndef USE_MANUAL_MEMORY
+    for (auto it = std::begin(m_bodies); it != std::end(m_bodies);)
+    {
+        it = it->second.body.expired() ? m_bodies.erase(it) : std::next(it);
+    }
+#endif
+    m_sweep_threshold = std::max(m_sweep_threshold, 2 * std::size(m_bodies));
+}
+
+ALObjectPtr VirtualMachine::run_loop(const Loop &t_loop, OpCode t_op)
+{
+    if (t_op == OpCode::WHILE)
+    {
+        try
+        {
+            while (is_truthy(run(*t_loop.head)))
+            {
+                try
+                {
+                    run(*t_loop.body);
+                }
+                catch (al_continue &)
+                {
+                    continue;
+                }
+            }
+        }
+        catch (al_break &)
+        {
+        }
+        return Qt;
+    }
+
+    auto list = run(*t_loop.head);
+    if (equal(list, Qnil))
+    {
+        return Qnil;
+    }
+
+    env::detail::ScopePushPop spp{ m_env };
+    m_env.bind(t_loop.symbol, Qnil);
+
+    try
+    {
+        for (auto list_element : list->children())
+        {
+            try
+            {
+                m_env.update(t_loop.symbol, list_element);
+                run(*t_loop.body);
+            }
+            catch (al_continue &)
+            {
+                continue;
+            }
+        }
+    }
+    catch (al_break &)
+    {
+    }
+
+    return Qt;
+}
+
+#ifdef ALISP_VM_COMPUTED_GOTO
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpedantic"
+#endif
+
+ALObjectPtr VirtualMachine::run(const Chunk &t_chunk)
+{
+    eval::detail::EvalDepthTrack track{ m_eval };
+    StackWindow window{ m_stack };
+
+    const auto *const code = t_chunk.code.data();
+    const auto &constants  = t_chunk.constants;
+    const auto *ip         = code;
+
+#ifdef ALISP_VM_COMPUTED_GOTO
+
+    static const void *dispatch_table[] = { &&L_PUSH_CONST,  &&L_LOAD_SYM,      &&L_SET_SYM,    &&L_POP,
+                                            &&L_JUMP,        &&L_JUMP_IF_NIL,   &&L_JUMP_IF_NOT_NIL,
+                                            &&L_CALL_PRIME,  &&L_LOAD_FUNC,     &&L_CALL,       &&L_EVAL,
+                                            &&L_WHILE,       &&L_DOLIST,        &&L_RETURN };
+
+#define VM_TARGET(op) L_##op:
+#define VM_NEXT() goto *dispatch_table[static_cast<std::size_t>(ip->op)]
+#define VM_BEGIN VM_NEXT();
+#define VM_END
+
+#else
+
+#define VM_TARGET(op) case OpCode::op:
+#define VM_NEXT() continue
+#define VM_BEGIN  \
+    for (;;)      \
+    {             \
+        switch (ip->op) \
+        {
+#define VM_END \
+    }          \
+    }
+
+#endif
+
+    VM_BEGIN
+
+    VM_TARGET(PUSH_CONST)
+    {
+        m_stack.push_back(constants[ip->arg]);
+        ++ip;
+        VM_NEXT();
+    }
+
+    VM_TARGET(LOAD_SYM)
+    {
+        m_stack.push_back(m_env.find(constants[ip->arg]));
+        ++ip;
+        VM_NEXT();
+    }
+
+    VM_TARGET(SET_SYM)
+    {
+        m_env.update(constants[ip->arg], m_stack.back());
+        m_stack.pop_back();
+        ++ip;
+        VM_NEXT();
+    }
+
+    VM_TARGET(POP)
+    {
+        m_stack.pop_back();
+        ++ip;
+        VM_NEXT();
+    }
+
+    VM_TARGET(JUMP)
+    {
+        ip = code + ip->arg;
+        VM_NEXT();
+    }
+
+    VM_TARGET(JUMP_IF_NIL)
+    {
+        const bool falsy = is_falsy(m_stack.back());
+        m_stack.pop_back();
+        ip = falsy ? code + ip->arg : ip + 1;
+        VM_NEXT();
+    }
+
+    VM_TARGET(JUMP_IF_NOT_NIL)
+    {
+        const bool truthy = is_truthy(m_stack.back());
+        m_stack.pop_back();
+        ip = truthy ? code + ip->arg : ip + 1;
+        VM_NEXT();
+    }
+
+    VM_TARGET(CALL_PRIME)
+    {
+        const auto &site = t_chunk.calls[ip->arg];
+        m_stack.push_back(m_eval.eval_callable(site.callee, site.args, site.form));
+        ++ip;
+        VM_NEXT();
+    }
+
+    VM_TARGET(LOAD_FUNC)
+    {
+        const auto &site = t_chunk.calls[ip->arg];
+        auto func        = m_env.find(site.callee);
+
+        if (func->check_prime_flag() or func->check_macro_flag() or !func->check_function_flag())
+        {
+            m_stack.push_back(m_eval.eval_callable(func, site.args, site.form));
+            ip = code + site.end;
+        }
+        else
+        {
+            m_stack.push_back(std::move(func));
+            ++ip;
+        }
+        VM_NEXT();
+    }
+
+    VM_TARGET(CALL)
+    {
+        const auto &site = t_chunk.calls[ip->arg];
+        const auto first = std::prev(std::end(m_stack), static_cast<std::ptrdiff_t>(site.argc));
+
+        auto args = make_object(ALObject::list_type(first, std::end(m_stack)));
+        m_stack.erase(first, std::end(m_stack));
+
+        auto func = std::move(m_stack.back());
+        m_stack.pop_back();
+        m_stack.push_back(m_eval.eval_callable(func, args, site.form, true));
+        ++ip;
+        VM_NEXT();
+    }
+
+    VM_TARGET(EVAL)
+    {
+        m_stack.push_back(m_eval.eval(constants[ip->arg]));
+        ++ip;
+        VM_NEXT();
+    }
+
+    VM_TARGET(WHILE)
+    {
+        m_stack.push_back(run_loop(t_chunk.loops[ip->arg], OpCode::WHILE));
+        ++ip;
+        VM_NEXT();
+    }
+
+    VM_TARGET(DOLIST)
+    {
+        m_stack.push_back(run_loop(t_chunk.loops[ip->arg], OpCode::DOLIST));
+        ++ip;
+        VM_NEXT();
+    }
+
+    VM_TARGET(RETURN)
+    {
+        return m_stack.back();
+    }
+
+    VM_END
+
+#undef VM_TARGET
+#undef VM_NEXT
+#undef VM_BEGIN
+#undef VM_END
+}
+
+#ifdef ALISP_VM_COMPUTED_GOTO
+#pragma GCC diagnostic pop
+#endif
+
+}  // namespace vm
+
+}  // namespace alisp
@@ -17,6 +17,7 @@
 
 #include "alisp/alisp/alisp_eval.hpp"
 #include "alisp/alisp/alisp_factory.hpp"
+#include "alisp/alisp/alisp_gc.hpp"
 #include "alisp/utility/macros.hpp"
 #include "alisp/alisp/alisp_object.hpp"
 #include "alisp/alisp/declarations/constants.hpp"
@@ -33,12 +34,52 @@ AsyncS::AsyncS(eval::Evaluator *t_eval, bool defer_init) : m_eval(t_eval), m_fla
 {
     AL_BIT_OFF(m_flags, INIT_FLAG);
 
+#ifdef USE_GC_MEMORY
+    gc::heap().add_roots(this, [this](gc::Marker &t_marker) {
+        {
+            std::lock_guard<std::mutex> guard(callback_queue_mutex);
+            auto callbacks = m_callback_queue;
+            while (!callbacks.empty())
+            {
+                t_marker.mark(callbacks.front().function);
+                t_marker.mark(callbacks.front().arguments);
+                callbacks.pop();
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> guard{ timers_mutex };
+            for (auto &timer : m_timers)
+            {
+                t_marker.mark(timer.callback);
+                t_marker.mark(timer.periodic);
+            }
+        }
+
+        std::lock_guard lock(Future::future_mutex);
+        future_registry.for_each([&t_marker](Future &t_future) {
+            t_marker.mark(t_future.value);
+            t_marker.mark(t_future.resolved);
+            t_marker.mark(t_future.success_state);
+            t_marker.mark(t_future.success_callback);
+            t_marker.mark(t_future.reject_callback);
+        });
+    });
+#endif
+
     if (!defer_init)
     {
         init();
     }
 }
 
+AsyncS::~AsyncS()
+{
+#ifdef USE_GC_MEMORY
+    gc::heap().remove_roots(this);
+#endif
+}
+
 void AsyncS::init()
 {
 
@@ -36,22 +36,14 @@ ALObjectPtr Fslice(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *
 
     const size_t start = static_cast<size_t>(ind_1->to_int());
 
-    size_t end = list->children().size();
+    size_t end = list->length();
     if (std::size(*obj) == 3)
     {
         auto ind_2 = eval_check(eval, obj, 2, &assert_int<size_t>);
-        end        = static_cast<size_t>(ind_2->to_int());
+        end        = std::min(static_cast<size_t>(ind_2->to_int()), end);
     }
 
-    ALObject::list_type new_list{};
-
-    auto &child = list->children();
-    for (auto i = start; i < end; ++i)
-    {
-        new_list.push_back(child[i]);
-    }
-
-    return make_object(new_list);
+    return list->sublist(start, end);
 }
 
 ALObjectPtr Fsort(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *eval)
@@ -118,7 +110,9 @@ ALObjectPtr Ffilter(const ALObjectPtr &obj, env::Environment *, eval::Evaluator
     auto list    = eval_check(eval, obj, 1, &assert_list<size_t>);
 
     ALObject::list_type new_list{};
-    for (auto &el : *list)
+    SequenceCursor cursor{ list };
+    ALObjectPtr el;
+    while (cursor.next(el))
     {
         if (is_truthy(eval->eval_callable(fun_obj, make_list(el))))
         {
@@ -136,8 +130,9 @@ ALObjectPtr Fany(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *ev
     auto list    = eval_check(eval, obj, 1, &assert_list<size_t>);
     auto fun_obj = eval_check(eval, obj, 0, &assert_function<size_t>);
 
-
-    for (auto &el : *list)
+    SequenceCursor cursor{ list };
+    ALObjectPtr el;
+    while (cursor.next(el))
     {
         if (is_truthy(eval->eval_callable(fun_obj, make_list(el))))
         {
@@ -155,8 +150,9 @@ ALObjectPtr Fall(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *ev
     auto fun_obj = eval_check(eval, obj, 0, &assert_function<size_t>);
     auto list    = eval_check(eval, obj, 1, &assert_list<size_t>);
 
-
-    for (auto &el : *list)
+    SequenceCursor cursor{ list };
+    ALObjectPtr el;
+    while (cursor.next(el))
     {
         if (is_falsy(eval->eval_callable(fun_obj, make_list(el))))
         {
@@ -76,7 +76,7 @@ ALObjectPtr Fto_string(const ALObjectPtr &t_obj, env::Environment *, eval::Evalu
 
     return make_visit(
       eval->eval(t_obj->i(0)),
-      is_function() >>= [](ALObjectPtr obj) { return make_string(obj->get_prop("--name--")->to_string()); },
+      is_function() >>= [](ALObjectPtr obj) { return make_string(obj->get_prop(PropKey::NAME)->to_string()); },
       is_char() >>= [](ALObjectPtr obj) { return make_string(std::string(1, char(obj->to_int()))); },
       type(ALObjectType::INT_VALUE) >>= [](ALObjectPtr obj) { return make_string(std::to_string(obj->to_int())); },
       type(ALObjectType::REAL_VALUE) >>=
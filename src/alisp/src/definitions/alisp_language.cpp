@@ -22,6 +22,7 @@
 
 #include "alisp/alisp/alisp_common.hpp"
 #include "alisp/alisp/alisp_env.hpp"
+#include "alisp/alisp/alisp_resolver.hpp"
 #include "alisp/alisp/alisp_eval.hpp"
 #include "alisp/alisp/alisp_object.hpp"
 #include "alisp/alisp/alisp_exception.hpp"
@@ -206,6 +207,89 @@ static ALObjectPtr catch_case_lippincott(ALObjectPtr t_obj, env::Environment *en
     return Qt;
 }
 
+static void collect_names(const ALObjectPtr &t_obj, ALObject::list_type &t_names)
+{
+    if (psym(t_obj))
+    {
+        if (t_obj == Qt or t_obj == Qnil or t_obj->to_string().front() == ':')
+        {
+            return;
+        }
+        for (auto &name : t_names)
+        {
+            if (name->symbol_id() == t_obj->symbol_id())
+            {
+                return;
+            }
+        }
+        t_names.push_back(t_obj);
+        return;
+    }
+
+    if (plist(t_obj))
+    {
+        for (auto &el : *t_obj)
+        {
+            collect_names(el, t_names);
+        }
+    }
+}
+
+// The names a lambda may capture are the symbols that appear anywhere in
+// its body, nested lambdas and quoted data included. They are computed once
+// for every lambda form that has a parameter list of its own to cache them.
+static ALObjectPtr captured_names(const ALObjectPtr &t_params, const ALObjectPtr &t_body)
+{
+    const auto key      = t_body->length() == 0 ? Qnil : t_body->i(0);
+    const bool cachable = !is_falsy(t_params);
+
+    if (cachable)
+    {
+        if (auto cached = t_params->get_prop(PropKey::CAPTURES); cached != nullptr and cached->i(0) == key)
+        {
+            return cached->i(1);
+        }
+    }
+
+    ALObject::list_type names;
+    collect_names(t_body, names);
+    auto captures = make_list(names);
+
+    if (cachable)
+    {
+        t_params->set_prop(PropKey::CAPTURES, make_object(key, captures));
+    }
+    return captures;
+}
+
+// The closure of a lambda is a flat list of symbol and value pairs with the
+// innermost binding of every captured name that is visible in the frame.
+static ALObjectPtr capture(env::Environment &t_env, const ALObjectPtr &t_names)
+{
+    auto cells = t_env.stack().frame_cells();
+    if (cells.empty())
+    {
+        return nullptr;
+    }
+
+    ALObject::list_type closure;
+    for (auto &name : *t_names)
+    {
+        for (auto it = std::end(cells); it != std::begin(cells);)
+        {
+            --it;
+            if (it->symbol->symbol_id() == name->symbol_id())
+            {
+                closure.push_back(it->symbol);
+                closure.push_back(it->value);
+                break;
+            }
+        }
+    }
+
+    return closure.empty() ? nullptr : make_list(closure);
+}
+
 }  // namespace detail
 
 ALObjectPtr Fimport(const ALObjectPtr &obj, env::Environment *env, eval::Evaluator *eval)
@@ -418,20 +502,25 @@ ALObjectPtr Flambda(const ALObjectPtr &obj, env::Environment *env, eval::Evaluat
         return Qnil;
     });
 
-    auto new_lambda = make_object(obj->i(0), splice(obj, 1));
+    // the parameter list is shared between all closures created from
+    // this form, so the body needs to be resolved only once
+    if (!is_falsy(obj->i(0)) and !obj->i(0)->check_resolved_flag())
+    {
+        env::resolve_function(*env, obj->i(0), splice(obj, 1));
+        obj->i(0)->set_resolved_flag();
+    }
+
+    auto body       = splice(obj, 1);
+    auto new_lambda = make_object(obj->i(0), body);
     new_lambda->set_function_flag();
-    new_lambda->set_prop("--name--", make_string("lambda"));
-    new_lambda->set_prop("--module--", make_string(env->current_module()));
+    new_lambda->set_prop(PropKey::NAME, make_string("lambda"));
+    new_lambda->set_prop(PropKey::MODULE, make_string(env->current_module()));
+    new_lambda->set_module(&env->current_module_ref());
 
-    ALObject::list_type closure_list;
-    for (const auto &scope : env->stack().current_frame())
+    if (auto closure = detail::capture(*env, detail::captured_names(obj->i(0), body)); closure != nullptr)
     {
-        for (const auto &[sym, val] : scope)
-        {
-            closure_list.push_back(make_object(make_string(sym), val));
-        }
+        new_lambda->set_prop(PropKey::CLOSURE, closure);
     }
-    new_lambda->set_prop("--closure--", make_list(closure_list));
 
     return new_lambda;
 }
@@ -502,11 +591,11 @@ ALObjectPtr Fif(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *evl
 
     if (is_truthy(evl->eval(obj->i(0))))
     {
-        return evl->eval(obj->i(1));
+        return evl->eval_tail(obj->i(1));
     }
     else if (obj->length() >= 3)
     {
-        return eval_list(evl, obj, 2);
+        return eval_list_tail(evl, obj, 2);
     }
     else
     {
@@ -518,6 +607,8 @@ ALObjectPtr Fwhile(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *
 {
     AL_CHECK(assert_min_size<1>(obj));
 
+    eval::detail::FlowScope loop{ *evl, eval::detail::FlowScope::Kind::LOOP };
+
     try
     {
         while (is_truthy(evl->eval(obj->i(0))))
@@ -530,6 +621,15 @@ ALObjectPtr Fwhile(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *
             {
                 continue;
             }
+
+            if (auto unwind = evl->consume_loop_unwind(); unwind == eval::Unwind::BREAK)
+            {
+                break;
+            }
+            else if (unwind == eval::Unwind::RETURN)
+            {
+                return evl->unwind_value();
+            }
         }
     }
     catch (al_break &)
@@ -545,7 +645,7 @@ ALObjectPtr Fwhen(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *e
 
     if (is_truthy(evl->eval(obj->i(0))))
     {
-        return eval_list(evl, obj, 1);
+        return eval_list_tail(evl, obj, 1);
     }
     return Qnil;
 }
@@ -556,7 +656,7 @@ ALObjectPtr Funless(const ALObjectPtr &obj, env::Environment *, eval::Evaluator
 
     if (!is_truthy(evl->eval(obj->i(0))))
     {
-        return eval_list(evl, obj, 1);
+        return eval_list_tail(evl, obj, 1);
     }
     return Qnil;
 }
@@ -575,14 +675,20 @@ ALObjectPtr Fdolist(const ALObjectPtr &obj, env::Environment *env, eval::Evaluat
     {
         return Qnil;
     };
+    AL_CHECK(assert_list(list));
 
     env::detail::ScopePushPop spp{ *env };
 
-    env->put(bound_sym, Qnil);
+    env->bind(bound_sym, Qnil);
+
+    SequenceCursor cursor{ list };
+    ALObjectPtr list_element;
+
+    eval::detail::FlowScope loop{ *evl, eval::detail::FlowScope::Kind::LOOP };
 
     try
     {
-        for (auto list_element : list->children())
+        while (cursor.next(list_element))
         {
             try
             {
@@ -593,6 +699,15 @@ ALObjectPtr Fdolist(const ALObjectPtr &obj, env::Environment *env, eval::Evaluat
             {
                 continue;
             }
+
+            if (auto unwind = evl->consume_loop_unwind(); unwind == eval::Unwind::BREAK)
+            {
+                break;
+            }
+            else if (unwind == eval::Unwind::RETURN)
+            {
+                return evl->unwind_value();
+            }
         }
     }
     catch (al_break &)
@@ -619,7 +734,9 @@ ALObjectPtr Fdotimes(const ALObjectPtr &obj, env::Environment *env, eval::Evalua
 
     env::detail::ScopePushPop spp{ *env };
 
-    env->put(bound_sym, Qnil);
+    env->bind(bound_sym, Qnil);
+
+    eval::detail::FlowScope loop{ *evl, eval::detail::FlowScope::Kind::LOOP };
 
     try
     {
@@ -634,6 +751,15 @@ ALObjectPtr Fdotimes(const ALObjectPtr &obj, env::Environment *env, eval::Evalua
             {
                 continue;
             }
+
+            if (auto unwind = evl->consume_loop_unwind(); unwind == eval::Unwind::BREAK)
+            {
+                break;
+            }
+            else if (unwind == eval::Unwind::RETURN)
+            {
+                return evl->unwind_value();
+            }
         }
     }
     catch (al_break &)
@@ -651,7 +777,7 @@ ALObjectPtr Fcond(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *e
     {
         if (is_truthy(evl->eval(condition->i(0))))
         {
-            return eval_list(evl, condition, 1);
+            return eval_list_tail(evl, condition, 1);
         }
     }
     return Qnil;
@@ -694,7 +820,7 @@ ALObjectPtr Fapply(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *
 
 ALObjectPtr Fprogn(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *evl)
 {
-    return eval_list(evl, obj, 0);
+    return eval_list_tail(evl, obj, 0);
 }
 
 ALObjectPtr Fprogn1(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *evl)
@@ -742,10 +868,10 @@ ALObjectPtr Flet(const ALObjectPtr &obj, env::Environment *env, eval::Evaluator
 
     for (auto [ob, cell] : cells)
     {
-        env->put(ob, cell);
+        env->bind(ob, cell);
     }
 
-    return eval_list(evl, obj, 1);
+    return eval_list_tail(evl, obj, 1);
 }
 
 ALObjectPtr Fletx(const ALObjectPtr &obj, env::Environment *env, eval::Evaluator *evl)
@@ -762,16 +888,16 @@ ALObjectPtr Fletx(const ALObjectPtr &obj, env::Environment *env, eval::Evaluator
         if (plist(var))
         {
             AL_CHECK(assert_size<2>(var));
-            env->put(var->i(0), evl->eval(var->i(1)));
+            env->bind(var->i(0), evl->eval(var->i(1)));
         }
         else
         {
             AL_CHECK(assert_symbol(var));
-            env->put(var, Qnil);
+            env->bind(var, Qnil);
         }
     }
 
-    return eval_list(evl, obj, 1);
+    return eval_list_tail(evl, obj, 1);
 }
 
 ALObjectPtr Fexit(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *evl)
@@ -845,26 +971,31 @@ ALObjectPtr Fequal(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *
 ALObjectPtr Freturn(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *evl)
 {
     AL_CHECK(assert_min_size<1>(obj));
-    if (std::size(*obj) == 0)
+    auto val = std::size(*obj) == 0 ? Qnil : evl->eval(obj->i(0));
+    if (!evl->start_unwind(eval::Unwind::RETURN, val))
     {
-        throw al_return(Qnil);
+        throw al_return(val);
     }
-    auto val = evl->eval(obj->i(0));
-    throw al_return(val);
-    return Qnil;
+    return val;
 }
 
-ALObjectPtr Fbreak(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *)
+ALObjectPtr Fbreak(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *evl)
 {
     AL_CHECK(assert_size<0>(obj));
-    throw al_break();
+    if (!evl->start_unwind(eval::Unwind::BREAK, Qnil))
+    {
+        throw al_break();
+    }
     return Qnil;
 }
 
-ALObjectPtr Fcontinue(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *)
+ALObjectPtr Fcontinue(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *evl)
 {
     AL_CHECK(assert_size<0>(obj));
-    throw al_continue();
+    if (!evl->start_unwind(eval::Unwind::CONTINUE, Qnil))
+    {
+        throw al_continue();
+    }
     return Qnil;
 }
 
@@ -884,7 +1015,7 @@ ALObjectPtr Fsym_list(const ALObjectPtr &obj, env::Environment *env, eval::Evalu
         }
         for (auto &[sym, _] : mod->get_root())
         {
-            syms.push_back(env::intern(sym));
+            syms.push_back(env::intern(env::symbol_name(sym)));
         }
         return make_list(syms);
     }
@@ -893,11 +1024,11 @@ ALObjectPtr Fsym_list(const ALObjectPtr &obj, env::Environment *env, eval::Evalu
     auto mod = env->current_module_ref();
     for (auto &[sym, _] : mod.get_root())
     {
-        syms.push_back(env::intern(sym));
+        syms.push_back(env::intern(env::symbol_name(sym)));
     }
-    for (auto &[sym, _] : env::Environment::g_internal_symbols)
+    for (auto &[_, sym] : env::Environment::g_internal_symbols)
     {
-        syms.push_back(env::intern(sym));
+        syms.push_back(sym);
     }
 
     return make_list(syms);
@@ -45,7 +45,9 @@ ALObjectPtr Fmapc(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *e
 
     if (plist(list))
     {
-        for (auto &el : list->children())
+        SequenceCursor cursor{ list };
+        ALObjectPtr el;
+        while (cursor.next(el))
         {
             if (psym(el) or plist(el))
             {
@@ -84,8 +86,11 @@ ALObjectPtr Fmapcar(const ALObjectPtr &obj, env::Environment *, eval::Evaluator
     AL_CHECK(assert_list(list));
 
     ALObject::list_type new_l;
+    new_l.reserve(list->length());
 
-    for (auto &el : list->children())
+    SequenceCursor cursor{ list };
+    ALObjectPtr el;
+    while (cursor.next(el))
     {
 
         if (psym(el) or plist(el))
@@ -105,7 +110,7 @@ ALObjectPtr Fcar(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *ev
 {
     AL_CHECK(assert_size<1>(obj));
     auto list = eval->eval(obj->i(0));
-    return list->i(0);
+    return list->element(0);
 }
 
 ALObjectPtr Fcons(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *eval)
@@ -113,7 +118,9 @@ ALObjectPtr Fcons(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *e
     AL_CHECK(assert_size<1>(obj));
     auto list = eval->eval(obj->i(0));
     AL_CHECK(assert_list(list));
-    return splice(list, 1);
+
+    const auto size = list->length();
+    return size == 0 ? Qnil : list->sublist(1, size);
 }
 
 ALObjectPtr Fcdr(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *eval)
@@ -121,7 +128,8 @@ ALObjectPtr Fcdr(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *ev
     AL_CHECK(assert_size<1>(obj));
     auto list = eval_check(eval, obj, 0, &assert_list<size_t>);
 
-    return splice(list, 1);
+    const auto size = list->length();
+    return size == 0 ? Qnil : list->sublist(1, size);
 }
 
 ALObjectPtr Fhead(const ALObjectPtr &obj, env::Environment *env, eval::Evaluator *eval)
@@ -139,7 +147,7 @@ ALObjectPtr Flast(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *e
     AL_CHECK(assert_size<1>(obj));
     auto list = eval_check(eval, obj, 0, &assert_list<size_t>);
 
-    return list->i(list->length() - 1);
+    return list->element(list->length() - 1);
 }
 
 ALObjectPtr Finit(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *eval)
@@ -147,7 +155,8 @@ ALObjectPtr Finit(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *e
     AL_CHECK(assert_size<1>(obj));
     auto list = eval_check(eval, obj, 0, &assert_list<size_t>);
 
-    return splice(list, 0, static_cast<ALObject::list_type::difference_type>(list->length() - 1));
+    const auto size = list->length();
+    return list->sublist(0, size == 0 ? 0 : size - 1);
 }
 
 ALObjectPtr Fpush(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *eval)
@@ -198,12 +207,12 @@ ALObjectPtr Fnth(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *ev
 
     AL_CHECK(assert_list(list));
 
-    if (static_cast<ALObject::list_type::size_type>(index->to_int()) >= std::size(list->children()))
+    if (static_cast<ALObject::list_type::size_type>(index->to_int()) >= list->length())
     {
         throw std::runtime_error("Index out of bound!");
     }
 
-    return list->i(static_cast<ALObject::list_type::size_type>(index->to_int()));
+    return list->element(static_cast<ALObject::list_type::size_type>(index->to_int()));
 }
 
 ALObjectPtr Ffind(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *eval)
@@ -371,6 +380,11 @@ ALObjectPtr Frange(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *
         return Qnil;
     }
 
+    if (step > 0 and start->to_int() < end->to_int())
+    {
+        return make_object(ALObject::range_type{ start->to_int(), end->to_int(), step });
+    }
+
     ALObject::list_type nums;
     for (auto i = start->to_int(); i < end->to_int(); i += step)
     {
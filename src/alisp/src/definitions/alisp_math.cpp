@@ -18,6 +18,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <functional>
 
 #include "alisp/alisp/alisp_common.hpp"
 #include "alisp/alisp/alisp_env.hpp"
@@ -35,10 +36,55 @@
 namespace alisp
 {
 
+namespace
+{
+
+// Most arithmetic has exactly two operands. The operands are evaluated
+// directly instead of into an argument list, their types are checked once
+// and the operation is done on ints if both of them are ints and on reals
+// otherwise.
+
+template<typename Operation>
+ALObjectPtr binary_arithmetic(eval::Evaluator *evl, const ALObjectPtr &obj, Operation &&t_op)
+{
+    const auto one = evl->eval(obj->i(0));
+    const auto two = evl->eval(obj->i(1));
+
+    if (one->is_int() and two->is_int())
+    {
+        return make_int(t_op(one->to_int(), two->to_int()));
+    }
+
+    AL_CHECK(assert_number(one, size_t{ 0 }); assert_number(two, size_t{ 1 }));
+    return make_double(t_op(one->to_real(), two->to_real()));
+}
+
+template<typename Operation>
+ALObjectPtr binary_comparison(eval::Evaluator *evl, const ALObjectPtr &obj, Operation &&t_op)
+{
+    const auto one = evl->eval(obj->i(0));
+    const auto two = evl->eval(obj->i(1));
+
+    if (one->is_int() and two->is_int())
+    {
+        return t_op(one->to_int(), two->to_int()) ? Qt : Qnil;
+    }
+
+    AL_CHECK(assert_number(one, size_t{ 0 }); assert_number(two, size_t{ 1 }));
+    return t_op(one->to_real(), two->to_real()) ? Qt : Qnil;
+}
+
+}  // namespace
 
 ALObjectPtr Fmultiply(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *evl)
 {
-    auto eval_obj = eval_transform(evl, obj);
+    if (obj->length() == 2)
+    {
+        return binary_arithmetic(evl, obj, std::multiplies<>{});
+    }
+
+    eval::ArgumentWindow args{ *evl, obj };
+    const auto &eval_obj = args.values();
 
     AL_CHECK(assert_numbers(eval_obj));
 
@@ -60,7 +106,13 @@ ALObjectPtr Fmultiply(const ALObjectPtr &obj, env::Environment *, eval::Evaluato
 
 ALObjectPtr Fplus(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *evl)
 {
-    auto eval_obj = eval_transform(evl, obj);
+    if (obj->length() == 2)
+    {
+        return binary_arithmetic(evl, obj, std::plus<>{});
+    }
+
+    eval::ArgumentWindow args{ *evl, obj };
+    const auto &eval_obj = args.values();
 
     AL_CHECK(assert_numbers(eval_obj));
 
@@ -82,7 +134,13 @@ ALObjectPtr Fplus(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *e
 
 ALObjectPtr Fminus(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *evl)
 {
-    auto eval_obj = eval_transform(evl, obj);
+    if (obj->length() == 2)
+    {
+        return binary_arithmetic(evl, obj, std::minus<>{});
+    }
+
+    eval::ArgumentWindow args{ *evl, obj };
+    const auto &eval_obj = args.values();
 
     AL_CHECK(assert_numbers(eval_obj));
 
@@ -103,7 +161,13 @@ ALObjectPtr Fminus(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *
 
 ALObjectPtr Fdev(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *evl)
 {
-    auto eval_obj = eval_transform(evl, obj);
+    if (obj->length() == 2)
+    {
+        return binary_arithmetic(evl, obj, std::divides<>{});
+    }
+
+    eval::ArgumentWindow args{ *evl, obj };
+    const auto &eval_obj = args.values();
 
     AL_CHECK(assert_numbers(eval_obj));
 
@@ -125,133 +189,54 @@ ALObjectPtr Flt(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *eva
 {
     AL_CHECK(assert_size<2>(obj));
 
-    const auto one = eval_check(eval, obj, 0, &assert_number<size_t>);
-
-    const auto two = eval_check(eval, obj, 1, &assert_number<size_t>);
-
-
-    if (one->to_real() < two->to_real())
-    {
-        return Qt;
-    }
-    else
-    {
-        warn::warn_math("Comparing non-numbers ");
-        return Qnil;
-    };
+    return binary_comparison(eval, obj, std::less<>{});
 }
 
 ALObjectPtr Fleq(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *eval)
 {
     AL_CHECK(assert_min_size<0>(obj));
 
-    const auto one = eval_check(eval, obj, 0, &assert_number<size_t>);
-
-    const auto two = eval_check(eval, obj, 1, &assert_number<size_t>);
-
-
-    if (one->to_real() <= two->to_real())
-    {
-        return Qt;
-    }
-    else
-    {
-        warn::warn_math("Comparing non-numbers ");
-        return Qnil;
-    }
+    return binary_comparison(eval, obj, std::less_equal<>{});
 }
 
 ALObjectPtr Fgt(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *eval)
 {
     AL_CHECK(assert_min_size<0>(obj));
 
-    const auto one = eval_check(eval, obj, 0, &assert_number<size_t>);
-
-    const auto two = eval_check(eval, obj, 1, &assert_number<size_t>);
-
-
-    if (one->to_real() > two->to_real())
-    {
-        return Qt;
-    }
-    else
-    {
-        warn::warn_math("Comparing non-numbers ");
-        return Qnil;
-    }
+    return binary_comparison(eval, obj, std::greater<>{});
 }
 
 ALObjectPtr Fgeq(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *eval)
 {
     AL_CHECK(assert_min_size<0>(obj));
 
-    const auto one = eval_check(eval, obj, 0, &assert_number<size_t>);
-
-    const auto two = eval_check(eval, obj, 1, &assert_number<size_t>);
-
-
-    if (one->to_real() >= two->to_real())
-    {
-        return Qt;
-    }
-    else
-    {
-        warn::warn_math("Comparing non-numbers ");
-        return Qnil;
-    }
+    return binary_comparison(eval, obj, std::greater_equal<>{});
 }
 
 ALObjectPtr Feq_math(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *eval)
 {
     AL_CHECK(assert_min_size<0>(obj));
 
-    const auto one = eval_check(eval, obj, 0, &assert_number<size_t>);
-
-    const auto two = eval_check(eval, obj, 1, &assert_number<size_t>);
-
-
-    if (one->to_real() == two->to_real())
-    {
-        return Qt;
-    }
-    else
-    {
-        warn::warn_math("Comparing non-numbers ");
-        return Qnil;
-    }
+    return binary_comparison(eval, obj, std::equal_to<>{});
 }
 
 ALObjectPtr Fneq(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *eval)
 {
     AL_CHECK(assert_min_size<0>(obj));
 
-    const auto one = eval_check(eval, obj, 0, &assert_number<size_t>);
-
-    const auto two = eval_check(eval, obj, 1, &assert_number<size_t>);
-
-
-    if (one->to_real() != two->to_real())
-    {
-        return Qt;
-    }
-    else
-    {
-        warn::warn_math("Comparing non-numbers ");
-        return Qnil;
-    }
+    return binary_comparison(eval, obj, std::not_equal_to<>{});
 }
 
 ALObjectPtr Fmod(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *eval)
 {
     AL_CHECK(assert_size<2>(obj));
 
-    const auto one = eval_check(eval, obj, 0, &assert_int<size_t>);
-
-    const auto two = eval_check(eval, obj, 1, &assert_int<size_t>);
+    const auto one = eval->eval(obj->i(0));
+    const auto two = eval->eval(obj->i(1));
 
-    auto res = one->to_int() % two->to_int();
+    AL_CHECK(assert_int(one, size_t{ 0 }); assert_int(two, size_t{ 1 }));
 
-    return make_object(res);
+    return make_int(one->to_int() % two->to_int());
 }
 
 ALObjectPtr Fpow(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *eval)
@@ -270,7 +255,8 @@ ALObjectPtr Fmin(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *ev
 {
     AL_CHECK(assert_min_size<1>(obj));
 
-    auto eval_obj = eval_transform(eval, obj);
+    eval::ArgumentWindow args{ *eval, obj };
+    const auto &eval_obj = args.values();
     AL_CHECK(assert_numbers(eval_obj));
     auto is_int = are_objects_int(eval_obj);
     if (is_int)
@@ -306,7 +292,8 @@ ALObjectPtr Fmax(const ALObjectPtr &obj, env::Environment *, eval::Evaluator *ev
 {
     AL_CHECK(assert_min_size<1>(obj));
 
-    auto eval_obj = eval_transform(eval, obj);
+    eval::ArgumentWindow args{ *eval, obj };
+    const auto &eval_obj = args.values();
     AL_CHECK(assert_numbers(eval_obj));
     auto is_int = are_objects_int(eval_obj);
     if (is_int)
@@ -40,6 +40,11 @@ ALObjectPtr Fprop_set(const ALObjectPtr &obj, env::Environment *, eval::Evaluato
 
     auto &prop_name = prop->to_string();
 
+    if (target->check_immediate_flag())
+    {
+        throw eval_error("Properties cannot be set on small integers and characters.");
+    }
+
     target->set_prop(prop_name, eval->eval(obj->i(2)));
 
     return Qt;
@@ -83,7 +88,7 @@ ALObjectPtr Fprop_list(const ALObjectPtr &obj, env::Environment *, eval::Evaluat
 
     auto target = eval->eval(obj->i(0));
     ALObject::list_type props;
-    for (auto &[name, _] : target->props())
+    for (auto &name : target->prop_names())
     {
         props.push_back(make_string(name));
     }
@@ -100,9 +105,8 @@ ALObjectPtr Fprop_remove(const ALObjectPtr &obj, env::Environment *, eval::Evalu
     auto prop = eval_check(eval, obj, 1, &assert_string<size_t>);
 
     const auto &prop_name = prop->to_string();
-    const auto removed    = target->props().erase(prop_name);
 
-    return removed > 0 ? Qt : Qnil;
+    return target->remove_prop(prop_name) ? Qt : Qnil;
 }
 
 }  // namespace alisp
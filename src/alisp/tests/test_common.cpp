@@ -49,6 +49,27 @@ TEST_CASE("Common Test [make]", "[common]")
         CHECK(make_double(12.12)->is_real());
         CHECK(make_list(make_int(12))->is_list());
     }
+
+    SECTION("immediates")
+    {
+        CHECK(make_int(12) == make_int(12));
+        CHECK(make_int(-5)->check_immediate_flag());
+        CHECK(make_int(-5)->to_int() == -5);
+        CHECK(!make_int(100000)->check_immediate_flag());
+        CHECK(make_int(100000)->to_int() == 100000);
+
+        CHECK(make_char('a') == make_char('a'));
+        CHECK(make_char('a') != make_int('a'));
+        CHECK(make_char('a')->check_char_flag());
+        CHECK(!make_int('a')->check_char_flag());
+
+        auto mutable_int = make_mutable(make_int(12));
+        CHECK(mutable_int != make_int(12));
+        CHECK(!mutable_int->check_immediate_flag());
+        CHECK(mutable_int->to_int() == 12);
+        CHECK(make_mutable(make_char('a'))->check_char_flag());
+        CHECK_THROWS(make_int(12)->set(static_cast<ALObject::int_type>(13)));
+    }
 }
 
 
@@ -75,6 +75,31 @@ TEST_CASE("Engine Test [imports]", "[engine]")
 }
 
 
+TEST_CASE("Engine Test [signatures]", "[engine]")
+{
+    using namespace alisp;
+
+    LanguageEngine engine;
+    std::cout.setstate(std::ios_base::failbit);
+    std::cerr.setstate(std::ios_base::failbit);
+
+    std::string input{ "(import 'fileio :all)" };
+    CHECK(engine.eval_statement(input).first);
+
+    input = "(f-directories \".\")";
+    CHECK(engine.eval_statement(input).first);
+
+    input = "(f-directories)";
+    CHECK(!engine.eval_statement(input).first);
+
+    input = "(f-directories \".\" \".\")";
+    CHECK(!engine.eval_statement(input).first);
+
+    std::cerr.clear();
+    std::cout.clear();
+}
+
+
 TEST_CASE("Engine Test [settings]", "[engine]")
 {
     using namespace alisp;
@@ -108,3 +133,36 @@ TEST_CASE("Engine Test [args]", "[engine]")
 
     std::cout.clear();
 }
+
+
+TEST_CASE("Engine Test [optimization levels]", "[engine]")
+{
+    using namespace alisp;
+
+    std::cout.setstate(std::ios_base::failbit);
+
+    const auto results = [](std::vector<EngineSettings> t_settings) {
+        LanguageEngine engine(std::move(t_settings));
+        std::string input{ R"raw(
+(defconst opt-width 8)
+(defconst opt-name "alisp")
+(defun opt-area (n) (* opt-width n 2 3))
+(defun opt-shadow (opt-width) (+ opt-width 1))
+(defvar opt-results
+  (list (+ 1 2 3) (* 2 (- 10 4)) (/ 7 2) (/ 7.0 2) (mod 7 3) (- 5 1) (pow 2 10) (min 3 1 2)
+        (<< 1 4) (>> 256 2) (or* 12 3) (< 1 2) (== 2 2.0) (and t nil) (not nil)
+        (string-append opt-name "-lang") (string-length opt-name) (string-reverse opt-name)
+        (if (> opt-width 4) 'wide 'narrow) (opt-area 5) (opt-shadow 1)
+        (let ((opt-width 1)) (+ opt-width 1)) (let* ((a 2) (b (* a 3))) (- b a 1))
+        (when (< 1 2) 1 (+ 1 1) 1) (unless (> 1 2) 'unless) '(+ 1 2)))
+)raw" };
+        CHECK(engine.eval_statement(input).first);
+        return dump(engine.get_value("opt-results"));
+    };
+
+    const auto plain = results({});
+    CHECK(plain == results({ EngineSettings::OPTIMIZATION }));
+    CHECK(plain == results({ EngineSettings::FULL_OPTIMIZATION }));
+
+    std::cout.clear();
+}
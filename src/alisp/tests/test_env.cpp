@@ -150,6 +150,41 @@ TEST_CASE("Environment Test [put]", "[env]")
 }
 
 
+TEST_CASE("Environment Test [symbol ids]", "[env]")
+{
+
+    using namespace alisp;
+    env::Environment env;
+    eval::Evaluator eval(env, nullptr);
+
+    SECTION("interning")
+    {
+        auto sym = env::intern("symbol-id-test");
+
+        CHECK(env::intern("symbol-id-test") == sym);
+        CHECK(make_symbol("symbol-id-test")->symbol_id() == sym->symbol_id());
+        CHECK(make_symbol("symbol-id-other")->symbol_id() != sym->symbol_id());
+        CHECK(env::symbol_name(sym->symbol_id()) == "symbol-id-test");
+    }
+
+    SECTION("lookup")
+    {
+        const std::string name(256, 'x');
+        env.define_variable(make_symbol(name), make_int(42));
+
+        CHECK(env.find(make_symbol(name))->to_int() == 42);
+        CHECK(env.find(env::intern(name))->to_int() == 42);
+        CHECK_THROWS(env.find(make_symbol(std::string(255, 'x'))));
+    }
+
+    SECTION("equality")
+    {
+        CHECK(equal(make_symbol("symbol-id-test"), env::intern("symbol-id-test")));
+        CHECK(!equal(make_symbol("symbol-id-test"), make_string("symbol-id-test")));
+        CHECK(!equal(make_symbol("symbol-id-test"), make_symbol("symbol-id-other")));
+    }
+}
+
 TEST_CASE("Environment Test [util]", "[env]")
 {
 
@@ -245,10 +280,13 @@ TEST_CASE("Environment Test [dumping]", "[env]")
     CHECK_NOTHROW(env.stack_dump());
     CHECK_NOTHROW(env.callstack_dump());
 
-    env.trace_call({ "let" });
-    env.trace_call({ "when" });
-    env.trace_call({ "if" });
-    env.trace_call({ "while" });
+    auto callee = make_prime(nullptr, "let");
+    auto form   = make_list(make_symbol("let"));
+
+    env.trace_call(getraw(callee), getraw(form));
+    env.trace_call(getraw(callee), getraw(form));
+    env.trace_call(getraw(callee), getraw(Qnil));
+    env.trace_call(getraw(Qnil), getraw(Qnil));
 
     CHECK_NOTHROW(env.stack_dump());
     CHECK_NOTHROW(env.callstack_dump());
@@ -263,3 +301,183 @@ TEST_CASE("Environment Test [dumping]", "[env]")
 
     std::cout.clear();
 }
+
+
+#ifdef ENABLE_STACK_TRACE
+TEST_CASE("Environment Test [call stack]", "[env]")
+{
+
+    using namespace alisp;
+    env::Environment env;
+    eval::Evaluator eval(env, nullptr);
+    parser::ALParser<env::Environment> pars(env);
+
+    std::string input{ "(outer)\n(inner)" };
+    auto forms = pars.parse(input, "__TEST__");
+    auto outer = make_prime(nullptr, "outer");
+    auto inner = make_list();
+
+    SECTION("frames")
+    {
+        env::detail::CallTracer first{ env, getraw(outer), getraw(forms[0]) };
+        {
+            env::detail::CallTracer second{ env, getraw(inner), getraw(forms[1]) };
+            CHECK(std::size(env.get_call_frames()) == 2);
+        }
+        CHECK(std::size(env.get_call_frames()) == 1);
+    }
+
+    SECTION("formatting")
+    {
+        env::detail::CallTracer first{ env, getraw(outer), getraw(forms[0]) };
+        env::detail::CallTracer second{ env, getraw(inner), getraw(Qnil) };
+
+        const auto calls = env.call_stack();
+        REQUIRE(std::size(calls) == 2);
+
+        CHECK(calls[0].m_function == "outer");
+        CHECK(calls[0].m_is_prime);
+        REQUIRE(calls[0].m_location.has_value());
+        CHECK(SourceMap::file_name(calls[0].m_location->file) == "__TEST__");
+
+        CHECK(calls[1].m_function == "anonymous");
+        CHECK(!calls[1].m_is_prime);
+        CHECK(!calls[1].m_location.has_value());
+    }
+
+    SECTION("cleared")
+    {
+        env::detail::CallTracer first{ env, getraw(outer), getraw(forms[0]) };
+        {
+            env::detail::CallTracer second{ env, getraw(inner), getraw(forms[1]) };
+
+            std::cout.setstate(std::ios_base::failbit);
+            second.dump();
+            std::cout.clear();
+
+            CHECK(std::empty(env.get_call_frames()));
+        }
+        CHECK(std::empty(env.get_call_frames()));
+    }
+
+    CHECK(std::empty(env.get_call_frames()));
+}
+#endif
+
+TEST_CASE("Environment Test [modules]", "[env]")
+{
+
+    using namespace alisp;
+    env::Environment env;
+    auto p = std::make_shared<parser::ALParser<env::Environment>>(env);
+    eval::Evaluator eval(env, p.get());
+
+    auto eval_str = [&](std::string input) {
+        ALObjectPtr res;
+        for (auto &form : p->parse(input, "__TEST__"))
+        {
+            res = eval.eval(form);
+        }
+        return res;
+    };
+
+    env.define_module("lib", "");
+    env.alias_module("lib", "lib");
+    {
+        env::detail::ModuleChange mc{ env, "lib" };
+        eval_str("(defun lib-module () --module--)");
+        eval_str("(defun lib-call (f) (funcall f))");
+    }
+
+    CHECK(env.current_module() == "--main--");
+    CHECK(env.get_module("lib")->get_symbol("lib-module")->module() == env.get_module("lib"));
+
+    SECTION("switching")
+    {
+        CHECK(eval_str("(funcall (modref 'lib 'lib-module))")->to_string() == "lib");
+        CHECK(eval_str("--module--")->to_string() == "--main--");
+        CHECK(env.current_module() == "--main--");
+    }
+
+    SECTION("nested")
+    {
+        CHECK(eval_str("(funcall (modref 'lib 'lib-call) (lambda () --module--))")->to_string() == "--main--");
+        CHECK(eval_str("(funcall (modref 'lib 'lib-call) (modref 'lib 'lib-module))")->to_string() == "lib");
+        CHECK(env.current_module() == "--main--");
+    }
+}
+
+TEST_CASE("Environment Test [lexical addressing]", "[env]")
+{
+
+    using namespace alisp;
+    env::Environment env;
+    auto p = std::make_shared<parser::ALParser<alisp::env::Environment>>(env);
+    eval::Evaluator eval(env, p.get());
+
+    auto run = [&](std::string input) {
+        auto res = Qnil;
+        for (auto &form : p->parse(input, "__TEST__"))
+        {
+            res = eval.eval(form);
+        }
+        return res;
+    };
+
+    std::cout.setstate(std::ios_base::failbit);
+
+    SECTION("slots")
+    {
+        run("(defun lex-fun (a b) (let ((c (+ a b))) (* c a)))");
+
+        auto fun = env.find(make_symbol("lex-fun"));
+        CHECK(fun->i(0)->i(0)->get_location() == 1);
+        CHECK(fun->i(0)->i(1)->get_location() == 2);
+        CHECK(run("(lex-fun 2 3)")->to_int() == 10);
+    }
+
+    SECTION("shadowing")
+    {
+        CHECK(run("(defun lex-shadow (a) (let ((a (+ a 1))) (setq a (* a 10)) a)) (lex-shadow 1)")->to_int() == 20);
+        CHECK(run("(defun lex-loop (n) (dolist (n '(1 2 3)) (setq n 0)) n) (lex-loop 5)")->to_int() == 5);
+    }
+
+    SECTION("dynamic bindings")
+    {
+        CHECK(run("(defun lex-dyn (a) (let x (+ a 1)) (+ x a)) (lex-dyn 1)")->to_int() == 3);
+    }
+
+    SECTION("closures")
+    {
+        CHECK(run("(defun lex-adder (n) (lambda (x) (+ x n))) (funcall (lex-adder 3) 4)")->to_int() == 7);
+    }
+
+    SECTION("closures [captures]")
+    {
+        CHECK(run("(defun lex-capture (a b) (let ((c 3)) (lambda (x) (+ x c a)))) (funcall (lex-capture 1 2) 10)")
+                ->to_int()
+              == 14);
+        CHECK(run("(defun lex-nested (a) (lambda () (lambda () a))) (funcall (funcall (lex-nested 5)))")->to_int()
+              == 5);
+        CHECK(run("(defun lex-shadow (a) (let ((a 2)) (lambda () a))) (funcall (lex-shadow 1))")->to_int() == 2);
+
+        auto res = run("(defun lex-many () (mapcar (lambda (n) (funcall (lambda () n))) '(1 2 3))) (lex-many)");
+        REQUIRE(res->length() == 3);
+        CHECK(res->i(0)->to_int() == 1);
+        CHECK(res->i(2)->to_int() == 3);
+    }
+
+    SECTION("globals")
+    {
+        run("(defun lex-glob () lex-var)");
+        CHECK_THROWS(run("(lex-glob)"));
+
+        run("(defvar lex-var 1)");
+        CHECK(run("(lex-glob)")->to_int() == 1);
+
+        run("(setq lex-var 5)");
+        CHECK(run("(lex-glob)")->to_int() == 5);
+    }
+
+    std::cout.clear();
+}
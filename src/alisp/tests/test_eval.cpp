@@ -22,6 +22,7 @@
 #include "alisp/alisp/alisp_parser.hpp"
 #include "alisp/alisp/alisp_eval.hpp"
 #include "alisp/alisp/alisp_env.hpp"
+#include "alisp/alisp/alisp_optimizer.hpp"
 
 #include <string>
 #include <vector>
@@ -318,6 +319,101 @@ TEST_CASE("Evaluator Test [language]", "[eval]")
     std::cout.clear();
 }
 
+TEST_CASE("Evaluator Test [flow control]", "[eval]")
+{
+    using namespace alisp;
+
+    env::Environment env;
+    auto p     = std::make_shared<parser::ALParser<alisp::env::Environment>>(env);
+    auto &pars = *p;
+    eval::Evaluator eval(env, p.get());
+    std::cout.setstate(std::ios_base::failbit);
+
+    auto eval_all = [&](std::string input) {
+        ALObjectPtr res = Qnil;
+        for (auto &obj : pars.parse(input, "__TEST__"))
+        {
+            res = eval.eval(obj);
+        }
+        return res;
+    };
+
+    SECTION("return from loop")
+    {
+        std::string input{ R"raw(
+(defun find-three (l)
+  (dolist (x l)
+    (let ((y x))
+      (cond ((== y 3) (if 't (return y))))))
+  'none)
+(find-three '(1 2 3 4)))raw" };
+
+        CHECK(eval_all(input)->to_int() == 3);
+        CHECK(!eval.is_unwinding());
+    }
+
+    SECTION("return from argument")
+    {
+        std::string input{ R"raw(
+(defvar flow-var 0)
+(defun set-and-return () (setq flow-var (return 1)) 2)
+(list (set-and-return) flow-var))raw" };
+
+        auto res = eval_all(input);
+        CHECK(res->i(0)->to_int() == 1);
+        CHECK(res->i(1)->to_int() == 0);
+    }
+
+    SECTION("break and continue")
+    {
+        std::string input{ R"raw(
+(let ((s 0))
+  (dotimes (i 10)
+    (when (== i 5) (break))
+    (when (== (mod i 2) 0) (continue))
+    (setq s (+ s i)))
+  s))raw" };
+
+        CHECK(eval_all(input)->to_int() == 4);
+    }
+
+    SECTION("nested loops")
+    {
+        std::string input{ R"raw(
+(let ((s 0))
+  (dotimes (i 3)
+    (dotimes (j 3)
+      (when (== j 1) (break))
+      (setq s (+ s 1))))
+  s))raw" };
+
+        CHECK(eval_all(input)->to_int() == 3);
+    }
+
+    SECTION("break from function")
+    {
+        std::string input{ R"raw(
+(defun stop-loop () (break))
+(let ((c 0))
+  (dotimes (i 10)
+    (setq c i)
+    (stop-loop))
+  c))raw" };
+
+        CHECK(eval_all(input)->to_int() == 0);
+    }
+
+    SECTION("return through funcall")
+    {
+        std::string input{ R"raw(
+(defun funcall-return () (funcall 'return 7) 8)
+(funcall-return))raw" };
+
+        CHECK(eval_all(input)->to_int() == 7);
+    }
+}
+
+
 TEST_CASE("Evaluator Test [colon-symbols]", "[eval]")
 {
     using namespace alisp;
@@ -550,6 +646,30 @@ TEST_CASE("Evaluator Test [math]", "[eval]")
         CHECK(res->to_int() == 4);
     }
 
+    SECTION("binary operands")
+    {
+        auto run = [&](std::string input) { return eval.eval(pars.parse(input, "__TEST__")[0]); };
+
+        CHECK(run("(* 6 7)")->is_int());
+        CHECK(run("(* 6 7)")->to_int() == 42);
+        CHECK(run("(/ 7 2)")->to_int() == 3);
+        CHECK(run("(mod 7 2)")->to_int() == 1);
+        CHECK(run("(- 7 2.5)")->is_real());
+        CHECK(run("(- 7 2.5)")->to_real() == 4.5_a);
+        CHECK(run("(/ 7.0 2)")->to_real() == 3.5_a);
+        CHECK(run("(+ 1 2 3 4)")->to_int() == 10);
+        CHECK(run("(- 10 1 2 3)")->to_int() == 4);
+
+        CHECK(is_truthy(run("(< 9007199254740992 9007199254740993)")));
+        CHECK(is_truthy(run("(== 2 2.0)")));
+        CHECK(is_truthy(run("(>= 2.5 2)")));
+        CHECK(is_falsy(run("(!= 2 2.0)")));
+
+        CHECK_THROWS(run("(+ 1 \"a\")"));
+        CHECK_THROWS(run("(< 'a 1)"));
+        CHECK_THROWS(run("(mod 7 2.0)"));
+    }
+
     std::cout.clear();
 }
 
@@ -1003,6 +1123,68 @@ TEST_CASE("Evaluator Test [lists]", "[eval]")
         CHECK(res->i(8)->to_int() == 9);
     }
 
+    SECTION("range [lazy]")
+    {
+        std::string input{ "(range 0 10000000 3)" };
+        auto res = eval.eval(pars.parse(input, "__TEST__")[0]);
+        CHECK(res->is_lazy());
+        CHECK(res->length() == 3333334);
+        CHECK(res->element(3333333)->to_int() == 9999999);
+
+        input    = "(nth (range 5 1000000) 1000)";
+        auto nth = eval.eval(pars.parse(input, "__TEST__")[0]);
+        CHECK(nth->to_int() == 1005);
+
+        input    = "(let ((s 0)) (dolist (i (range 0 100000)) (setq s (+ s i))) s)";
+        auto sum = eval.eval(pars.parse(input, "__TEST__")[0]);
+        CHECK(sum->to_int() == 4999950000);
+
+        input       = "(mapcar (lambda (x) (* x x)) (range 1 4))";
+        auto mapped = eval.eval(pars.parse(input, "__TEST__")[0]);
+        CHECK(mapped->length() == 3);
+        CHECK(mapped->i(2)->to_int() == 9);
+
+        CHECK(res->i(1)->to_int() == 3);
+        CHECK(!res->is_lazy());
+        CHECK(res->length() == 3333334);
+    }
+
+    SECTION("cdr [shared]")
+    {
+        std::string input{ "(cdr (cdr '(1 2 3 4)))" };
+        auto res = eval.eval(pars.parse(input, "__TEST__")[0]);
+        CHECK(res->is_lazy());
+        CHECK(res->length() == 2);
+        CHECK(res->element(0)->to_int() == 3);
+        CHECK(res->element(1)->to_int() == 4);
+
+        input    = "(let ((a (list 1 2 3)) (b nil) (c nil)) (setq b (cdr a)) (setq c (cdr b)) (push b 9) (list a b c))";
+        auto cow = eval.eval(pars.parse(input, "__TEST__")[0]);
+        CHECK(cow->i(0)->length() == 3);
+        CHECK(cow->i(1)->length() == 3);
+        CHECK(cow->i(1)->i(2)->to_int() == 9);
+        CHECK(cow->i(2)->length() == 1);
+        CHECK(cow->i(2)->i(0)->to_int() == 3);
+
+        input    = "(defun sum-list (l) (if l (+ (car l) (sum-list (cdr l))) 0))";
+        eval.eval(pars.parse(input, "__TEST__")[0]);
+        input    = "(sum-list (mapcar (lambda (x) x) (range 0 50)))";
+        auto sum = eval.eval(pars.parse(input, "__TEST__")[0]);
+        CHECK(sum->to_int() == 1225);
+
+        input       = "(slice '(1 2 3 4 5) 1 3)";
+        auto sliced = eval.eval(pars.parse(input, "__TEST__")[0]);
+        CHECK(sliced->length() == 2);
+        CHECK(sliced->i(0)->to_int() == 2);
+        CHECK(sliced->i(1)->to_int() == 3);
+
+        input      = "(cdr (range 0 10 2))";
+        auto range = eval.eval(pars.parse(input, "__TEST__")[0]);
+        CHECK(range->is_lazy());
+        CHECK(range->length() == 4);
+        CHECK(range->element(0)->to_int() == 2);
+    }
+
     std::cout.clear();
 }
 
@@ -1030,6 +1212,327 @@ TEST_CASE("Evaluator Test [function call]", "[eval]")
     std::cout.clear();
 }
 
+TEST_CASE("Evaluator Test [call site cache]", "[eval]")
+{
+    using namespace alisp;
+
+    std::cout.setstate(std::ios_base::failbit);
+
+    env::Environment env;
+    auto p     = std::make_shared<parser::ALParser<alisp::env::Environment>>(env);
+    auto &pars = *p;
+    eval::Evaluator eval(env, p.get());
+
+    std::string input{ R"raw(
+(defvar callee (lambda (x) (+ x 1)))
+(defun call-callee (x) (callee x))
+(call-callee 2)
+(setq callee (lambda (x) (* x 10)))
+(call-callee 2)
+(let ((callee (lambda (x) 0))) (callee 2))
+(call-callee 3))raw" };
+    auto par_res = pars.parse(input, "__TEST__");
+
+    eval.eval(par_res[0]);
+    eval.eval(par_res[1]);
+    CHECK(eval.eval(par_res[2])->to_int() == 3);
+
+    eval.eval(par_res[3]);
+    CHECK(eval.eval(par_res[4])->to_int() == 20);
+
+    CHECK(eval.eval(par_res[5])->to_int() == 0);
+    CHECK(eval.eval(par_res[6])->to_int() == 30);
+
+    std::cout.clear();
+}
+
+TEST_CASE("Evaluator Test [macro expansion cache]", "[eval]")
+{
+    using namespace alisp;
+
+    std::cout.setstate(std::ios_base::failbit);
+
+    env::Environment env;
+    auto p     = std::make_shared<parser::ALParser<alisp::env::Environment>>(env);
+    auto &pars = *p;
+    eval::Evaluator eval(env, p.get());
+
+    std::string input{ R"raw(
+(defvar expansions 0)
+(defmacro twice (x) (setq expansions (+ expansions 1)) `(* 2 ,x))
+(defun call-twice (y) (twice y))
+(call-twice 1)
+(call-twice 2)
+expansions
+(setq twice (lambda (x) (* 3 x)))
+(call-twice 2))raw" };
+    auto par_res = pars.parse(input, "__TEST__");
+
+    eval.eval(par_res[0]);
+    eval.eval(par_res[1]);
+    eval.eval(par_res[2]);
+    CHECK(eval.eval(par_res[3])->to_int() == 2);
+    CHECK(eval.eval(par_res[4])->to_int() == 4);
+    CHECK(eval.eval(par_res[5])->to_int() == 1);
+
+    eval.eval(par_res[6]);
+    CHECK(eval.eval(par_res[7])->to_int() == 6);
+
+    std::cout.clear();
+}
+
+TEST_CASE("Evaluator Test [argument window]", "[eval]")
+{
+    using namespace alisp;
+
+    std::cout.setstate(std::ios_base::failbit);
+
+    env::Environment env;
+    auto p     = std::make_shared<parser::ALParser<alisp::env::Environment>>(env);
+    auto &pars = *p;
+    eval::Evaluator eval(env, p.get());
+
+    SECTION("nested")
+    {
+        std::string input{ "(defun add3 (a b c) (+ a b c)) (add3 (add3 1 2 3) (+ 4 (add3 1 1 1)) (- 10 5))" };
+        auto par_res = pars.parse(input, "__TEST__");
+
+        eval.eval(par_res[0]);
+        CHECK(eval.eval(par_res[1])->to_int() == 18);
+    }
+
+    SECTION("rest")
+    {
+        std::string input{ "(defun rest-args (a &rest xs) xs) (rest-args 1 (+ 1 1) 3) (rest-args 4 5 6)" };
+        auto par_res = pars.parse(input, "__TEST__");
+
+        eval.eval(par_res[0]);
+        auto first = eval.eval(par_res[1]);
+        eval.eval(par_res[2]);
+
+        REQUIRE(first->length() == 2);
+        CHECK(first->i(0)->to_int() == 2);
+        CHECK(first->i(1)->to_int() == 3);
+    }
+
+    SECTION("error")
+    {
+        std::string input{ "(defun add3 (a b c) (+ a b c)) (add3 1 (add3 2 (car 3) 4) 5) (add3 1 2 (+ 3 4))" };
+        auto par_res = pars.parse(input, "__TEST__");
+
+        eval.eval(par_res[0]);
+        CHECK_THROWS(eval.eval(par_res[1]));
+        CHECK(eval.eval(par_res[2])->to_int() == 10);
+    }
+
+    SECTION("overflow")
+    {
+        std::string input{ "(+" };
+        for (size_t i = 0; i < 20000; ++i)
+        {
+            input += " 1";
+        }
+        input += ")";
+        auto par_res = pars.parse(input, "__TEST__");
+
+        CHECK(eval.eval(par_res[0])->to_int() == 20000);
+    }
+
+    std::cout.clear();
+}
+
+
+TEST_CASE("Evaluator Test [tail calls]", "[eval]")
+{
+    using namespace alisp;
+
+    std::cout.setstate(std::ios_base::failbit);
+
+    env::Environment env;
+    auto p     = std::make_shared<parser::ALParser<alisp::env::Environment>>(env);
+    auto &pars = *p;
+    eval::Evaluator eval(env, p.get());
+
+    SECTION("if")
+    {
+        std::string input{ R"raw(
+(defun count-down (n acc) (if (== n 0) acc (count-down (- n 1) (+ acc 1))))
+(count-down 10000 0))raw" };
+        auto par_res = pars.parse(input, "__TEST__");
+
+        eval.eval(par_res[0]);
+        CHECK(eval.eval(par_res[1])->to_int() == 10000);
+    }
+
+    SECTION("cond, let, progn and when")
+    {
+        std::string input{ R"raw(
+(defun walk (n)
+  (cond ((== n 0) 42)
+        ('t (let ((m (- n 1))) (progn (when 't (walk m)))))))
+(walk 5000))raw" };
+        auto par_res = pars.parse(input, "__TEST__");
+
+        eval.eval(par_res[0]);
+        CHECK(eval.eval(par_res[1])->to_int() == 42);
+    }
+
+    SECTION("mutual")
+    {
+        std::string input{ R"raw(
+(defun my-even (n) (if (== n 0) 't (my-odd (- n 1))))
+(defun my-odd (n) (if (== n 0) nil (my-even (- n 1))))
+(my-even 5001))raw" };
+        auto par_res = pars.parse(input, "__TEST__");
+
+        eval.eval(par_res[0]);
+        eval.eval(par_res[1]);
+        CHECK(is_falsy(eval.eval(par_res[2])));
+    }
+
+    SECTION("not in tail position")
+    {
+        std::string input{ R"raw(
+(defvar seen 0)
+(defun record (x) (setq seen (+ seen x)))
+(defun loop-record () (let ((i 0)) (while (< i 3) (setq i (+ i 1)) (record i)) i))
+(loop-record)
+seen
+(defun depth (n) (if (== n 0) 0 (+ 1 (depth (- n 1)))))
+(depth 1000))raw" };
+        auto par_res = pars.parse(input, "__TEST__");
+
+        eval.eval(par_res[0]);
+        eval.eval(par_res[1]);
+        eval.eval(par_res[2]);
+        CHECK(eval.eval(par_res[3])->to_int() == 3);
+        CHECK(eval.eval(par_res[4])->to_int() == 6);
+
+        eval.eval(par_res[5]);
+        CHECK_THROWS(eval.eval(par_res[6]));
+    }
+
+    std::cout.clear();
+}
+
+
+TEST_CASE("Evaluator Test [optimizer]", "[eval]")
+{
+    using namespace alisp;
+
+    std::cout.setstate(std::ios_base::failbit);
+
+    env::Environment env;
+    auto p     = std::make_shared<parser::ALParser<alisp::env::Environment>>(env);
+    auto &pars = *p;
+    eval::Evaluator eval(env, p.get());
+    optimizer::MainOptimizer opt(eval);
+
+    SECTION("folding")
+    {
+        std::string input{ R"raw((+ 1 2 3) (string-length "alisp") (< 1 2.5) (+ x 1 2))raw" };
+        auto par_res = pars.parse(input, "__TEST__");
+        opt.optimize(par_res);
+
+        CHECK(par_res[0]->to_int() == 6);
+        CHECK(par_res[1]->to_int() == 5);
+        CHECK(par_res[2] == Qt);
+        CHECK(par_res[3]->length() == 4);
+    }
+
+    SECTION("unsafe")
+    {
+        std::string input{ R"raw((/ 1 0) (mod 4 0) (- 1) (<< 1 -1) (+ 1 "one") (string-upper "alisp") (string-reverse "psila"))raw" };
+        auto par_res = pars.parse(input, "__TEST__");
+        opt.optimize(par_res);
+
+        for (auto &obj : par_res)
+        {
+            CHECK(plist(obj));
+        }
+    }
+
+    SECTION("constants")
+    {
+        std::string input{ R"raw(
+(defconst width (* 4 2))
+(* width 2)
+(let ((width 1)) (* width 2))
+(defun area (width) (* width 2))
+(quote (* width 2))
+(defconst name "alisp")
+(string-length name))raw" };
+        auto par_res = pars.parse(input, "__TEST__");
+        opt.optimize(par_res);
+
+        CHECK(par_res[0]->i(2)->to_int() == 8);
+        CHECK(par_res[1]->to_int() == 16);
+        CHECK(psym(par_res[2]->i(2)->i(1)));
+        CHECK(psym(par_res[3]->i(3)->i(1)));
+        CHECK(psym(par_res[4]->i(1)->i(1)));
+        CHECK(plist(par_res[6]));
+    }
+
+    SECTION("bindings")
+    {
+        std::string input{ R"raw((let ((max (+ 1 2))) max))raw" };
+        auto par_res = pars.parse(input, "__TEST__");
+        opt.optimize(par_res);
+
+        CHECK(psym(par_res[0]->i(1)->i(0)->i(0)));
+        CHECK(par_res[0]->i(1)->i(0)->i(1)->to_int() == 3);
+    }
+
+    SECTION("algebraic")
+    {
+        std::string input{ R"raw((+ x 1 2) (* 1 x 1) (- x 1 y 2) (+ x 1.5 2))raw" };
+        auto par_res = pars.parse(input, "__TEST__");
+        opt.optimize(par_res, optimizer::Level::ALGEBRAIC);
+
+        CHECK(par_res[0]->length() == 3);
+        CHECK(par_res[0]->i(2)->to_int() == 3);
+        CHECK(par_res[1]->length() == 2);
+        CHECK(par_res[2]->length() == 4);
+        CHECK(par_res[2]->i(3)->to_int() == 3);
+        CHECK(par_res[3]->length() == 4);
+    }
+
+    SECTION("inlining")
+    {
+        std::string input{ R"raw(
+(defvar offset 5)
+(defun square (x) (* x x))
+(defun clamp (x lo hi) (max lo (min x hi)))
+(defun shifted (x) (+ x offset))
+(defun early (x) (return x))
+(defun replaced (x) x)
+(setq replaced (lambda (x) (* 2 x)))
+(square (square 2))
+(let ((x 2)) (clamp (square (+ x 1)) 0 5))
+(shifted 1)
+(early 1)
+(replaced 1))raw" };
+        auto par_res = pars.parse(input, "__TEST__");
+        opt.optimize(par_res);
+
+        CHECK(eq(par_res[7]->i(0), Plet));
+        CHECK(eq(par_res[8]->i(2)->i(0), Plet));
+        CHECK(psym(par_res[9]->i(0)));
+        CHECK(psym(par_res[10]->i(0)));
+        CHECK(psym(par_res[11]->i(0)));
+
+        for (size_t i = 0; i < 7; ++i)
+        {
+            eval.eval(par_res[i]);
+        }
+        CHECK(eval.eval(par_res[7])->to_int() == 16);
+        CHECK(eval.eval(par_res[8])->to_int() == 5);
+        CHECK(eval.eval(par_res[9])->to_int() == 6);
+    }
+
+    std::cout.clear();
+}
+
 
 TEST_CASE("Evaluator Test [exception]", "[eval]")
 {
@@ -18,6 +18,7 @@
 #include "catch2/catch.hpp"
 
 #include "alisp/alisp/alisp_engine.hpp"
+#include "alisp/alisp/alisp_gc.hpp"
 
 #include <string>
 #include <vector>
@@ -107,3 +108,39 @@ TEST_CASE("Memory Test [reading and writing 3]", "[memory]")
 
     std::cout.clear();
 }
+
+
+#ifdef USE_GC_MEMORY
+
+TEST_CASE("Memory Test [garbage collection]", "[memory]")
+{
+    using namespace alisp;
+
+    LanguageEngine engine;
+
+    std::cout.setstate(std::ios_base::failbit);
+
+    auto define = R"((defvar kept (list 1 2 (list "three" 4.0)))
+(defun make-garbage (n) (dotimes (i n) (list i (list i i) (+ i 0.5))))
+)"s;
+    CHECK(engine.eval_statement(define).first);
+
+    const auto before = gc::heap().stats();
+
+    auto garbage = R"((make-garbage 5000))"s;
+    for (size_t i = 0; i < 40; ++i)
+    {
+        CHECK(engine.eval_statement(garbage).first);
+    }
+
+    const auto after = gc::heap().stats();
+    CHECK(after.collections > before.collections);
+    CHECK(after.freed > before.freed);
+
+    auto check = R"((assert (equal kept (list 1 2 (list "three" 4.0)))))"s;
+    CHECK(engine.eval_statement(check).first);
+
+    std::cout.clear();
+}
+
+#endif
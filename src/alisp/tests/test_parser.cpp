@@ -775,3 +775,35 @@ TEST_CASE("Parser Test [init object]", "[parser]")
         CHECK(res[0]->i(1)->to_int() == 2);
     }
 }
+
+#ifdef ENABLE_LINE_TRACE
+TEST_CASE("Parser Test [source locations]", "[parser]")
+{
+    alisp::env::Environment env;
+    alisp::parser::ALParser<alisp::env::Environment> pars(env);
+
+    std::string input{ "(println 12)\n\n  (println (+ 1 2))" };
+    auto res = pars.parse(input, "__LOCATIONS__");
+
+    REQUIRE(std::size(res) == 2);
+
+    const auto first  = alisp::SourceMap::find(alisp::getraw(res[0]));
+    const auto second = alisp::SourceMap::find(alisp::getraw(res[1]));
+    const auto inner  = alisp::SourceMap::find(alisp::getraw(res[1]->i(1)));
+
+    REQUIRE(first != nullptr);
+    REQUIRE(second != nullptr);
+    REQUIRE(inner != nullptr);
+
+    CHECK(second->line == first->line + 2);
+    CHECK(inner->line == second->line);
+    CHECK(inner->column > second->column);
+    CHECK(alisp::SourceMap::file_name(first->file) == "__LOCATIONS__");
+    CHECK(first->file == second->file);
+
+    CHECK(res[0]->check_located_flag());
+    CHECK(!res[0]->prop_exists("--line--"));
+    CHECK(!res[0]->prop_exists("--file--"));
+    CHECK(alisp::SourceMap::find(alisp::getraw(res[0]->i(1))) == nullptr);
+}
+#endif
@@ -0,0 +1,134 @@
+/*   Alisp - the alisp interpreted language
+     Copyright (C) 2020 Stanislav Arnaudov
+
+ This program is free software; you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation; either version 2 of the License, or
+ (at your option) any prior version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License along
+ with this program; if not, write to the Free Software Foundation, Inc.,
+ 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA. */
+
+
+#include "catch2/catch.hpp"
+
+#include "alisp/alisp/alisp_common.hpp"
+#include "alisp/alisp/alisp_parser.hpp"
+#include "alisp/alisp/alisp_eval.hpp"
+#include "alisp/alisp/alisp_env.hpp"
+#include "alisp/alisp/alisp_vm.hpp"
+
+#include <string>
+#include <vector>
+#include <iostream>
+
+using Catch::Matchers::Contains;
+
+
+TEST_CASE("VM Test [compile]", "[vm]")
+{
+    using namespace alisp;
+
+    env::Environment env;
+    parser::ALParser<alisp::env::Environment> pars{ env };
+
+    SECTION("constants")
+    {
+        std::string input{ "42" };
+        auto chunk = vm::compile(pars.parse(input, "__TEST__")[0]);
+
+        REQUIRE(std::size(chunk->code) == 2);
+        CHECK(chunk->code[0].op == vm::OpCode::PUSH_CONST);
+        CHECK(chunk->code[1].op == vm::OpCode::RETURN);
+    }
+
+    SECTION("control flow")
+    {
+        std::string input{ "(if a (when b 1) 2)" };
+        auto code = vm::disassemble(*vm::compile(pars.parse(input, "__TEST__")[0]));
+
+        CHECK_THAT(code, Contains("JUMP_IF_NIL"));
+        CHECK_THAT(code, Contains("LOAD_SYM a"));
+        CHECK_THAT(code, !Contains("CALL_PRIME"));
+    }
+
+    SECTION("calls")
+    {
+        std::string input{ "(foo (+ 1 2) x)" };
+        auto chunk = vm::compile(pars.parse(input, "__TEST__")[0]);
+        auto code  = vm::disassemble(*chunk);
+
+        CHECK_THAT(code, Contains("LOAD_FUNC"));
+        CHECK_THAT(code, Contains("CALL_PRIME"));
+        REQUIRE(std::size(chunk->calls) == 2);
+        CHECK(chunk->calls[0].argc == 2);
+    }
+}
+
+TEST_CASE("VM Test [execution]", "[vm]")
+{
+    using namespace alisp;
+
+    env::Environment env;
+    auto p     = std::make_shared<parser::ALParser<alisp::env::Environment>>(env);
+    auto &pars = *p;
+    eval::Evaluator eval(env, p.get());
+    vm::VirtualMachine machine(env, eval);
+    eval.set_vm(&machine);
+
+    std::cout.setstate(std::ios_base::failbit);
+
+    auto run = [&](std::string input) {
+        auto res = Qnil;
+        for (auto &form : pars.parse(input, "__TEST__"))
+        {
+            res = machine.eval(form);
+        }
+        return res;
+    };
+
+    SECTION("if")
+    {
+        CHECK(run("(if (> 3 2) 10 20)")->to_int() == 10);
+        CHECK(run("(if (< 3 2) 10 20 30)")->to_int() == 30);
+        CHECK(run("(if nil 10)") == Qnil);
+    }
+
+    SECTION("and/or")
+    {
+        CHECK(run("(and 1 2 3)") == Qt);
+        CHECK(run("(and 1 nil 3)") == Qnil);
+        CHECK(run("(or nil nil 3)") == Qt);
+        CHECK(run("(or)") == Qnil);
+    }
+
+    SECTION("loops")
+    {
+        auto res = run("(defvar s 0) (defvar i 0)"
+                       "(while (< i 10) (setq i (+ i 1)) (when (== i 5) (continue)) (setq s (+ s i)))"
+                       "s");
+        CHECK(res->to_int() == 50);
+
+        res = run("(defvar l 0) (dolist (el '(1 2 3 4)) (when (== el 3) (break)) (setq l (+ l el))) l");
+        CHECK(res->to_int() == 3);
+    }
+
+    SECTION("functions")
+    {
+        auto res = run("(defun fact (n) (if (<= n 1) 1 (* n (fact (- n 1))))) (fact 10)");
+        CHECK(res->to_int() == 3628800);
+        CHECK(machine.cached_bodies() == 1);
+
+        res = run("(defun early (n) (dolist (el '(1 2 3)) (when (== el n) (return (* el 10)))) 0) (early 2)");
+        CHECK(res->to_int() == 20);
+
+        res = run("(funcall (lambda (a b) (+ a b)) 4 5)");
+        CHECK(res->to_int() == 9);
+    }
+}
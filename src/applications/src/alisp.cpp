@@ -52,9 +52,9 @@ std::vector<std::string> alisp::prompt::get_completions(const std::string &t_wor
         sym_vec.push_back(std::string(name) += ".");
     }
 
-    for (auto &[name, _] : g_alisp_engine->get_modules().at("--main--")->root_scope())
+    for (auto &[id, _] : g_alisp_engine->get_modules().at("--main--")->root_scope())
     {
-        sym_vec.push_back(name);
+        sym_vec.push_back(alisp::env::symbol_name(id));
     }
 
 
@@ -69,9 +69,9 @@ std::vector<std::string> alisp::prompt::get_completions(const std::string &t_wor
         }
 
         std::vector<std::string> words{};
-        for (auto &[name, _] : g_alisp_engine->get_modules().at(pack)->root_scope())
+        for (auto &[id, _] : g_alisp_engine->get_modules().at(pack)->root_scope())
         {
-            sym_vec.push_back(pack + "." + name);
+            sym_vec.push_back(pack + "." + alisp::env::symbol_name(id));
         }
     }
 
@@ -111,6 +111,8 @@ struct Options
     std::vector<std::string> warnings;
 
     bool optimize{ false };
+    bool full_optimize{ false };
+    bool bytecode{ false };
 
     bool debug_logging{ false };
 
@@ -140,6 +142,9 @@ int main(int argc, char *argv[])
 
       opts.no_debug << clipp::option("-n", "--no-assertions") % "Disables debug mode",
       opts.optimize << clipp::option("-O", "--optimize") % "Enable code optimizations",
+      opts.full_optimize << clipp::option("-O2", "--full-optimize")
+        % "Enable code optimizations that assume integer arithmetic",
+      opts.bytecode << clipp::option("-B", "--bytecode") % "Execute the code through the bytecode virtual machine",
 
 #ifdef DEUBG_LOGGING
       opts.debug_logging << clipp::option("-DL", "--debug-logging") % "Enable lots of debuggin output.",
@@ -255,6 +260,8 @@ int main(int argc, char *argv[])
     if (opts.quick) settings.push_back(alisp::EngineSettings::QUICK_INIT);
     if (opts.no_debug) settings.push_back(alisp::EngineSettings::DISABLE_DEBUG_MODE);
     if (opts.optimize) settings.push_back(alisp::EngineSettings::OPTIMIZATION);
+    if (opts.full_optimize) settings.push_back(alisp::EngineSettings::FULL_OPTIMIZATION);
+    if (opts.bytecode) settings.push_back(alisp::EngineSettings::BYTECODE);
 
     alisp::LanguageEngine alisp_engine{
         settings, std::move(opts.args), std::move(opts.includes), std::move(opts.warnings)
@@ -248,6 +248,25 @@ template<typename T, size_t tag> class Registry
     }
 
     T &operator[](uint32_t t_ind) { return get_memory(t_ind)->res; }
+
+    template<typename Callable> void for_each(Callable &&t_fun)
+    {
+        for (auto &res : inline_res)
+        {
+            if ((res.id & VALID_BIT) != 0)
+            {
+                t_fun(res.res);
+            }
+        }
+
+        for (auto &res : dyn_res)
+        {
+            if ((res.id & VALID_BIT) != 0)
+            {
+                t_fun(res.res);
+            }
+        }
+    }
 };
 
 
@@ -18,6 +18,8 @@
 #pragma once
 
 
+#include <limits>
+
 #include <robin_hood.h>
 
 